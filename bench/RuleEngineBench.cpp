@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "DebugLog.h"
+#include "ModuleManager.h"
+#include "Rule.h"
+#include "RuleManager.h"
+
+#include <nlohmann/json.hpp>
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// ============================================
+// RuleEngineBench - 规则引擎微基准（dglab_bench）
+// 覆盖值模式解析、求值、规则配置解析与数值变化级联，每项结果以一行 JSON 输出到标准输出
+// 同时校验结果（原生字节码与 QJSEngine 回退路径结果一致、级联到达通道规则），任一校验失败时退出码为 1
+// 通过 friend 访问 Rule::parse_pattern 与 RuleManager::parse_config 等私有接口
+// ============================================
+class RuleEngineBench {
+public:
+    // -------------------- 配置 --------------------
+    struct Options {
+        int max_rules = 100000;   ///< 合成规则图的最大规模
+        int min_time_ms = 300;    ///< 每项基准的最短计时（毫秒）
+        std::string filter;       ///< 仅运行名称包含该子串的基准（空为全部）
+    };
+
+    explicit RuleEngineBench(Options options)
+        : options_(std::move(options)) {
+    }
+
+    /// @brief 运行全部基准
+    /// @return 进程退出码（有校验失败时为 1）
+    int run() {
+        setup_modules();
+        bench_parse_pattern();
+        bench_compute_value();
+        for (int rules = 10; rules <= options_.max_rules; rules *= 10) {
+            for (const char* shape : { "chain", "fanout", "diamond" }) {
+                nlohmann::json config = make_graph(shape, rules);
+                bench_parse_config(shape, config);
+                bench_cascade(shape, config);
+            }
+        }
+        if (failures_ > 0) {
+            std::cerr << failures_ << " 项校验失败" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    // -------------------- 常量 --------------------
+    static constexpr const char* MODULE_NAME = "CS2 GSI 模块"; ///< 默认模块名（数据源所在模块）
+    static constexpr const char* SOURCE_ID = "health";         ///< 级联源头数值 ID
+    static constexpr int REDUCE_FAN_IN = 16;                   ///< fanout 图汇聚树的扇入
+
+    // -------------------- 计时 --------------------
+    /// @brief 单项基准结果
+    struct Sample {
+        size_t iterations = 0; ///< 迭代次数
+        double mean_ns = 0;    ///< 平均耗时（纳秒/次）
+        double min_ns = 0;     ///< 最短耗时（纳秒/次）
+        double median_ns = 0;  ///< 中位耗时（纳秒/次）
+    };
+
+    /// @brief 重复执行直至达到最短计时（每批至少一次，批大小按上一批耗时自适应）
+    Sample measure(const std::function<void()>& body) const {
+        using clock = std::chrono::steady_clock;
+        std::vector<double> per_op;
+        size_t batch = 1;
+        size_t total = 0;
+        double elapsed_ns = 0;
+        const double budget_ns = options_.min_time_ms * 1e6;
+        while (elapsed_ns < budget_ns || per_op.size() < 3) {
+            auto start = clock::now();
+            for (size_t i = 0; i < batch; ++i) {
+                body();
+            }
+            double batch_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            per_op.push_back(batch_ns / static_cast<double>(batch));
+            elapsed_ns += batch_ns;
+            total += batch;
+            // 批耗时不足 1ms 时加大批量，降低计时开销占比
+            if (batch_ns < 1e6 && batch < (size_t{ 1 } << 20)) {
+                batch *= 2;
+            }
+        }
+        Sample sample;
+        sample.iterations = total;
+        sample.mean_ns = elapsed_ns / static_cast<double>(total);
+        std::sort(per_op.begin(), per_op.end());
+        sample.min_ns = per_op.front();
+        sample.median_ns = per_op[per_op.size() / 2];
+        return sample;
+    }
+
+    /// @brief 输出一行 JSON 结果
+    void report(const std::string& bench, nlohmann::json params, const Sample& sample) const {
+        nlohmann::json line = std::move(params);
+        line["bench"] = bench;
+        line["iterations"] = sample.iterations;
+        line["mean_ns"] = sample.mean_ns;
+        line["min_ns"] = sample.min_ns;
+        line["median_ns"] = sample.median_ns;
+        std::cout << line.dump() << std::endl;
+    }
+
+    /// @brief 是否运行指定基准
+    bool enabled(const std::string& bench) const {
+        return options_.filter.empty() || bench.find(options_.filter) != std::string::npos;
+    }
+
+    /// @brief 记录一项校验结果（失败时输出到标准错误并计数）
+    bool check(bool ok, const std::string& what) {
+        if (!ok) {
+            std::cerr << "校验失败: " << what << std::endl;
+            ++failures_;
+        }
+        return ok;
+    }
+
+    // -------------------- 环境 --------------------
+    /// @brief 注册默认模块并接入递增数据源（每次查询必然变化，保证级联被触发）
+    void setup_modules() {
+        auto& module_manager = ModuleManager::instance();
+        module_manager.set_data_source([this](const std::string&) { return ++source_counter_ % 100; });
+        module_manager.init();
+        // 先查询一次使数值进入“已获取”状态
+        module_manager.query_value(MODULE_NAME, SOURCE_ID);
+    }
+
+    // -------------------- 合成规则图 --------------------
+    /// @brief 规则名（零填充，使 JSON 对象的键序与规则序号一致）
+    static std::string rule_name(int index) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "r%06d", index);
+        return buf;
+    }
+
+    /// @brief 生成合成规则图（序号 1 为源头，读取 {id:health}；最后一条规则挂载通道 A）
+    /// @param shape chain：线性链；fanout：1 个源头 → 多个并列消费者 → 16 路汇聚树；
+    ///              diamond：菱形串联（每段两条分支汇合，分支共享上游）
+    /// @param rules 规则数量（fanout/diamond 按形状取整，实际数量见输出）
+    static nlohmann::json make_graph(const std::string& shape, int rules) {
+        std::vector<std::string> patterns;
+        patterns.reserve(static_cast<size_t>(rules) + 1);
+        patterns.push_back("{id:" + std::string(SOURCE_ID) + "}+1");
+        auto ref = [](int index) { return "{rule:" + std::to_string(index) + "}"; };
+        if (shape == "chain") {
+            for (int i = 2; i <= rules; ++i) {
+                patterns.push_back(ref(i - 1) + "+1");
+            }
+        }
+        else if (shape == "fanout") {
+            // 汇聚树约占 1/15，其余为并列消费者
+            int consumers = std::max(1, rules - 1 - (rules - 1) / (REDUCE_FAN_IN - 1));
+            std::vector<int> layer;
+            for (int i = 0; i < consumers; ++i) {
+                patterns.push_back(ref(1) + "*" + std::to_string(i % 7 + 1));
+                layer.push_back(static_cast<int>(patterns.size()));
+            }
+            while (layer.size() > 1) {
+                std::vector<int> next;
+                for (size_t begin = 0; begin < layer.size(); begin += REDUCE_FAN_IN) {
+                    size_t end = std::min(layer.size(), begin + REDUCE_FAN_IN);
+                    std::string pattern;
+                    for (size_t i = begin; i < end; ++i) {
+                        pattern += (i == begin ? "" : "+") + ref(layer[i]);
+                    }
+                    patterns.push_back(pattern);
+                    next.push_back(static_cast<int>(patterns.size()));
+                }
+                layer.swap(next);
+            }
+        }
+        else {
+            // 每段 3 条规则：左右分支引用上一汇合点，汇合点引用两条分支
+            int join = 1;
+            for (int i = 1; i + 3 <= rules; i += 3) {
+                patterns.push_back(ref(join) + "+1");
+                patterns.push_back(ref(join) + "*2");
+                int left = static_cast<int>(patterns.size()) - 1;
+                patterns.push_back(ref(left) + "+" + ref(left + 1));
+                join = static_cast<int>(patterns.size());
+            }
+        }
+
+        nlohmann::json config = nlohmann::json::object();
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            int index = static_cast<int>(i) + 1;
+            nlohmann::json rule = {
+                {"mode", 1},
+                {"valuePattern", patterns[i]},
+                {"enabled", true},
+            };
+            if (i + 1 == patterns.size()) {
+                rule["parents"] = nlohmann::json::array({ "A" });
+            }
+            config[rule_name(index)] = rule;
+        }
+        return config;
+    }
+
+    // -------------------- 基准项 --------------------
+    /// @brief Rule::parse_pattern：占位符扫描 + 字节码编译
+    void bench_parse_pattern() {
+        if (!enabled("parse_pattern")) {
+            return;
+        }
+        const std::vector<std::pair<std::string, std::string>> cases = {
+            { "id_ref", "{id:health}" },
+            { "arith_8", "({id:health}+{id:armor})*2-{rule:1}/3+{rule:2}%7-{id:money}+{rule:3}*{rule:4}" },
+            { "fallback", "{id:health}**2" },
+        };
+        for (const auto& [name, pattern] : cases) {
+            Rule rule("bench", "", 1, pattern, true, {}, 1);
+            Sample sample = measure([&rule]() { rule.parse_pattern(); });
+            report("parse_pattern", { {"case", name}, {"native", rule.is_value_pattern_native()} }, sample);
+        }
+    }
+
+    /// @brief Rule::compute_value：原生字节码与 QJSEngine 回退路径（计时前校验两条路径结果一致）
+    void bench_compute_value() {
+        if (!enabled("compute_value")) {
+            return;
+        }
+        const std::vector<std::pair<std::string, std::string>> cases = {
+            { "id_ref", "{id:health}" },
+            { "arith_8", "({id:health}+{id:armor})*2-{rule:1}/3+{rule:2}%7-{id:money}+{rule:3}*{rule:4}" },
+            { "div_mod", "{id:health}/{id:armor}+{id:health}%{id:armor}-{id:money}/-{id:armor}" },
+            { "unary", "-({id:health}-{id:armor})*-3+-{id:money}" },
+            { "fallback", "{id:health}**2" },
+        };
+        for (const auto& [name, pattern] : cases) {
+            Rule rule("bench", "", 1, pattern, true, {}, 1);
+            check_parity(name, rule);
+            std::vector<std::optional<int>> values(rule.get_placeholder_count(), 3);
+            volatile int sink = 0;
+            Sample sample = measure([&]() {
+                sink = rule.compute_value(values).value_or(0);
+            });
+            (void)sink;
+            report("compute_value", { {"case", name}, {"native", rule.is_value_pattern_native()} }, sample);
+        }
+    }
+
+    /// @brief 校验原生字节码与 QJSEngine 回退路径的求值结果一致（含零除数、溢出与负的中间结果）
+    /// @note 回退路径按文本替换占位符，负数输入会拼出 "--7" 这类非法表达式，故输入均为非负数
+    void check_parity(const std::string& name, const Rule& rule) {
+        const std::vector<int> inputs = { 3, 0, 7, 1, 200, 65536, 2147483647 };
+        for (size_t shift = 0; shift < inputs.size(); ++shift) {
+            // 每个占位符取不同的输入，覆盖各种组合
+            std::vector<std::optional<int>> values;
+            for (size_t i = 0; i < rule.get_placeholder_count(); ++i) {
+                values.push_back(inputs[(shift + i) % inputs.size()]);
+            }
+            std::optional<int> actual = rule.compute_value(values);
+            int expected = rule.evaluate_expression(rule.evaluate_value_pattern(values));
+            check(actual == expected, "compute_value[" + name + "] 原生/回退结果不一致（输入偏移 "
+                + std::to_string(shift) + "）：" + std::to_string(actual.value_or(0)) + " != " + std::to_string(expected));
+        }
+    }
+
+    /// @brief RuleManager::parse_config：规则构建 + 索引/拓扑/槽位/有效启用位 + 快照发布
+    void bench_parse_config(const std::string& shape, const nlohmann::json& config) {
+        if (!enabled("parse_config")) {
+            return;
+        }
+        auto& manager = RuleManager::instance();
+        Sample sample = measure([&]() {
+            std::lock_guard<std::mutex> lock(manager.mutex_);
+            manager.parse_config(config);
+        });
+        report("parse_config", { {"shape", shape}, {"rules", config.size()} }, sample);
+    }
+
+    /// @brief 数值变化级联：ModuleManager::query_value → values_changed → on_module_values_changed
+    /// （工作线程未启动，同步执行整个传播波次）
+    void bench_cascade(const std::string& shape, const nlohmann::json& config) {
+        if (!enabled("cascade")) {
+            return;
+        }
+        auto& manager = RuleManager::instance();
+        auto& module_manager = ModuleManager::instance();
+        {
+            std::lock_guard<std::mutex> lock(manager.mutex_);
+            manager.parse_config(config);
+        }
+        manager.set_channel_enabled("A", true);
+        Sample sample = measure([&]() { module_manager.query_value(MODULE_NAME, SOURCE_ID); });
+        manager.set_channel_enabled("A", false);
+        std::optional<int> sink = manager.get_rule_last_result(rule_name(static_cast<int>(config.size())));
+        check(sink.has_value(), "cascade[" + shape + ", " + std::to_string(config.size()) + "] 级联未到达通道规则");
+        report("cascade", { {"shape", shape}, {"rules", config.size()}, {"sink_computed", sink.has_value()} },
+            sample);
+    }
+
+    // -------------------- 成员变量 --------------------
+    Options options_;         ///< 运行选项
+    int source_counter_ = 0;  ///< 递增数据源计数
+    int failures_ = 0;        ///< 校验失败次数
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    // 基准输出仅保留 JSON 行，关闭日志
+    DebugLog::instance().set_default_log_level(LOG_NONE);
+    DebugLog::instance().set_all_log_level(LOG_NONE);
+
+    RuleEngineBench::Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-rules" && i + 1 < argc) {
+            options.max_rules = std::atoi(argv[++i]);
+        }
+        else if (arg == "--min-time-ms" && i + 1 < argc) {
+            options.min_time_ms = std::atoi(argv[++i]);
+        }
+        else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else {
+            std::cerr << "用法: dglab_bench [--max-rules N] [--min-time-ms MS] [--filter NAME]" << std::endl;
+            return 2;
+        }
+    }
+    return RuleEngineBench(options).run();
+}
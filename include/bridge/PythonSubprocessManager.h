@@ -5,60 +5,120 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QIODevice>
 #include <QJsonObject>
-#include <QMutex>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QObject>
 #include <QProcess>
 #include <QTcpSocket>
-#include <QWaitCondition>
+#include <QTimer>
 
 #include <atomic>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <map>
+#include <unordered_map>
+#include <utility>
 
 // ============================================
 // PythonSubprocessManager - Python 子进程管理与通信
+// 全部调用在所属线程以事件驱动完成，没有线程阻塞等待 Python：
+// 请求以 req_id 登记到待响应表后直接写出，最多 MAX_IN_FLIGHT 个请求同时在途（其余排队），
+// 响应在 on_socket_ready_read 中按 req_id 匹配并回调，单个定时器周期扫描待响应表处理超时
+// 连接建立后先以 JSON 发送 hello 协商消息格式：对端支持时切换为长度前缀 CBOR 帧，否则保持每行一条 JSON
+// 传输方式：本地套接字（QLocalServer 监听 Unix 域套接字，路径以 --ipc 传给 Python，由 Python 主动连接，
+// 连接建立即就绪）或 TCP 回环（解析 Python 输出的端口号后连接，Windows 使用）；收发只经由 QIODevice 接口
 // ============================================
 class PythonSubprocessManager : public QObject {
     Q_OBJECT
 
 public:
+    // -------------------- 常量 --------------------
+    static constexpr int MAX_IN_FLIGHT = 16;             ///< 同时在途（已发送、未收到响应）的最大请求数
+    static constexpr int TIMEOUT_SWEEP_INTERVAL_MS = 50; ///< 超时扫描间隔（毫秒，有待响应请求时运行）
+    static constexpr int HELLO_TIMEOUT_MS = 2000;        ///< 消息格式协商超时（毫秒，超时视为连接失败并断开）
+    static constexpr qint64 FRAME_HEADER_SIZE = 4;       ///< CBOR 帧头字节数（负载长度，大端 uint32）
+    static constexpr quint32 MAX_FRAME_BYTES = 16 * 1024 * 1024; ///< 单帧负载上限，超过视为流损坏并断开
+    static constexpr int LOCAL_CONNECT_TIMEOUT_MS = 10000; ///< 本地套接字模式下等待 Python 连接的超时（毫秒）
+
+    /// @brief 与 Python 服务之间的传输方式
+    enum class Transport {
+        AUTO,  ///< 自动：Windows 使用 TCP，其他平台使用 LOCAL
+        LOCAL, ///< 本地套接字（Unix 域套接字，Python 以 --ipc 路径主动连接；Windows 下回退为 TCP）
+        TCP    ///< TCP 回环（Python 监听随机端口并输出到 stdout）
+    };
+
+    /// @brief 与 Python 服务之间的消息格式
+    enum class FrameFormat {
+        JSON, ///< 每条消息一行紧凑 JSON（默认，兼容不支持协商的旧版 Bridge.py）
+        CBOR  ///< 4 字节大端负载长度 + CBOR 负载
+    };
+
     // -------------------- 构造/析构 --------------------
     /// @brief 构造函数
     explicit PythonSubprocessManager(QObject* parent = nullptr);
     ~PythonSubprocessManager();
 
     // -------------------- 公共接口 --------------------
-    /// @brief 启动 Python 子进程并尝试 TCP 连接
+    /// @brief 启动 Python 子进程并建立连接
     /// @param python_executable Python 解释器路径
     /// @param script_path 要运行的脚本路径
-    void start_process(const QString& python_executable, const QString& script_path);
+    /// @param transport 传输方式
+    void start_process(const QString& python_executable, const QString& script_path, Transport transport = Transport::AUTO);
+
+    /// @brief 检查是否已与 Python 服务建立连接
+    inline bool is_connected() const { return connected_; }
 
-    /// @brief 检查是否已与 Python 服务建立 TCP 连接
-    inline bool is_connected() const { return socket_ && socket_->state() == QTcpSocket::ConnectedState; }
+    /// @brief 获取实际使用的传输方式
+    /// @return LOCAL 或 TCP（start_process 前为 TCP）
+    inline Transport get_transport() const { return transport_; }
 
-    /// @brief 异步调用 Python 服务（非阻塞）
+    /// @brief 将配置字符串解析为传输方式
+    /// @param name "auto"/"local"/"tcp"（不区分大小写，无法识别时为 AUTO）
+    /// @return 传输方式
+    static Transport transport_from_string(const QString& name);
+
+    /// @brief 异步调用 Python 服务（非阻塞，任意线程；非所属线程调用时投递到所属线程执行）
     /// @param cmd 要发送的 JSON 命令
-    /// @param callback 回调函数，参数为响应 JSON
-    /// @param timeout 超时时间（毫秒）
+    /// @param callback 回调函数，参数为响应 JSON（在所属线程调用；超时或进程退出时为错误响应）
+    /// @param timeout 超时时间（毫秒，自调用起计时，含排队时间）
     void call(const QJsonObject& cmd, std::function<void(const QJsonObject&)> callback, int timeout = 5000);
 
+    /// @brief 获取当前消息格式
+    /// @return 协商完成前为 JSON
+    inline FrameFormat get_frame_format() const { return frame_format_; }
+
 private:
     // -------------------- 成员变量 --------------------
-    QProcess* process_;  ///< 子进程对象
-    QTcpSocket* socket_; ///< TCP 套接字
-    int port_;           ///< Python 服务监听的端口
-
-    // 同步等待相关
-    mutable QMutex mutex_;      ///< 保护 wait_cond_、last_response_、response_received_
-    QWaitCondition wait_cond_;  ///< 条件变量，用于同步等待响应
-    QJsonObject last_response_; ///< 最近收到的响应
-    bool response_received_;    ///< 是否已收到响应
-
-    // 异步回调相关
-    std::atomic<int> next_token_{0};                                       ///< 下一个请求 token
-    QMap<int, std::function<void(const QJsonObject&)>> pending_callbacks_; ///< 待处理回调
-    QMutex callback_mutex_;                                                ///< 保护 pending_callbacks_
+    QProcess* process_;                    ///< 子进程对象
+    QIODevice* socket_ = nullptr;          ///< 当前连接（tcp_socket_ 或 local_socket_），收发只经由该接口
+    QTcpSocket* tcp_socket_;               ///< TCP 套接字
+    QLocalServer* local_server_ = nullptr; ///< 本地套接字服务端（LOCAL 模式）
+    QLocalSocket* local_socket_ = nullptr; ///< Python 连入的本地套接字（LOCAL 模式）
+    QTimer* connect_timer_;                ///< 等待 Python 连接的超时定时器（LOCAL 模式）
+    Transport transport_ = Transport::TCP; ///< 实际使用的传输方式
+    bool connected_ = false;               ///< 是否已建立连接
+    int port_;                             ///< Python 服务监听的端口（TCP 模式）
+
+    // 待响应请求相关（仅所属线程访问）
+    /// @brief 待响应请求
+    struct PendingCall {
+        std::function<void(const QJsonObject&)> callback; ///< 响应回调
+        qint64 deadline_ms = 0;                           ///< 超时时刻（clock_ 毫秒）
+        bool sent = false;                                ///< 是否已发送（否则仍在 queued_ 中排队）
+    };
+    int next_token_ = 0;                                ///< 上一个请求 token（req_id）
+    std::unordered_map<int, PendingCall> pending_;      ///< req_id → 待响应请求
+    std::deque<std::pair<int, QJsonObject>> queued_;    ///< 等待发送的请求 (req_id, 命令)，在途请求达到上限时排队
+    int in_flight_count_ = 0;                           ///< 已发送、未收到响应的请求数
+    QTimer* timeout_timer_;                             ///< 超时扫描定时器
+    QElapsedTimer clock_;                               ///< 超时计时时钟
+
+    // 消息格式相关（仅所属线程访问）
+    FrameFormat frame_format_ = FrameFormat::JSON; ///< 当前消息格式
+    bool negotiating_ = false;                     ///< 是否正在协商（期间排队请求暂不发送）
 
     std::atomic<bool> stopping_{false}; ///< 析构时停止标志
 
@@ -66,17 +126,44 @@ private:
     /// @brief 处理子进程输出（stdout/stderr）
     void process_output(const QByteArray& data, bool is_error);
 
-    /// @brief 从输出中解析 TCP 端口号
+    /// @brief 从输出中解析 TCP 端口号（仅 TCP 模式）
     void parse_port_from_output(const QByteArray& data);
 
-    /// @brief 通过 socket 发送 JSON 对象
-    void send_json(const QJsonObject& obj);
+    /// @brief 创建本地套接字服务端并开始监听
+    /// @return 成功返回 true（失败时回退为 TCP）
+    bool listen_local();
+
+    /// @brief 立即断开当前连接（丢弃未发送数据）
+    void abort_socket();
+
+    /// @brief 连接出错或断开：以错误响应完成全部待响应请求并通知
+    void handle_socket_error();
 
-    /// @brief 同步发送命令并等待响应（仅供内部 call 的后台任务使用）
-    QJsonObject send_command(const QJsonObject& cmd, int timeout);
+    /// @brief 按当前消息格式编码并通过 socket 发送
+    /// @param obj 消息
+    void send_message(const QJsonObject& obj);
+
+    /// @brief 发送 hello 协商消息格式（连接建立后调用，协商结束后发送排队请求）
+    void negotiate_format();
+
+    /// @brief 处理一条已解码的消息：响应按 req_id 回调，主动消息转发
+    /// @param obj 消息
+    void handle_message(const QJsonObject& obj);
+
+    /// @brief 在途请求未达上限时依次发送排队的请求
+    void pump_queue();
+
+    /// @brief 完成一个待响应请求：移出待响应表并调用回调（请求已不存在时忽略）
+    /// @param token 请求 token（req_id）
+    /// @param response 响应（或超时/失败时的错误响应）
+    void complete_call(int token, const QJsonObject& response);
+
+    /// @brief 以错误响应完成全部待响应请求（进程退出、连接断开时调用）
+    /// @param message 错误信息
+    void fail_all_pending(const QString& message);
 
 signals:
-    /// @brief 子进程启动并 TCP 连接成功（或失败）时发出
+    /// @brief 子进程启动并连接成功（或失败）时发出
     void started(bool success, const QString& error_string);
 
     /// @brief 子进程结束时发出
@@ -99,6 +186,14 @@ private slots:
     void on_socket_error(QTcpSocket::SocketError error);
     void on_socket_ready_read();
 
+    // 本地套接字事件
+    void on_local_new_connection();
+    void on_local_socket_error(QLocalSocket::LocalSocketError error);
+    void on_local_connect_timeout();
+
+    // 超时扫描
+    void on_timeout_sweep();
+
     // 输出处理
     void handle_stdout();
     void handle_stderr();
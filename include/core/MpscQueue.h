@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+// ============================================
+// MpscQueue - 多生产者单消费者无锁队列（Vyukov 侵入式链表）
+// 生产者 push 仅一次原子交换，不加锁、不阻塞；仅允许一个消费者线程调用 try_pop
+// 生产者与消费者可同时操作，try_pop 返回空时队列可能处于某个生产者的中间状态，稍后重试即可
+// ============================================
+template<typename T>
+class MpscQueue {
+public:
+    // -------------------- 构造/析构 --------------------
+    MpscQueue();
+    ~MpscQueue();
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 入队（任意线程，无锁）
+    /// @param value 元素
+    void push(T value);
+
+    /// @brief 出队（仅消费者线程）
+    /// @return 队首元素，队列为空返回 std::nullopt
+    std::optional<T> try_pop();
+
+    /// @brief 队列是否为空（仅消费者线程，结果为近似值）
+    bool empty() const;
+
+private:
+    // -------------------- 节点 --------------------
+    struct Node {
+        std::atomic<Node*> next{ nullptr }; ///< 下一节点
+        std::optional<T> value;             ///< 元素（哨兵节点为空）
+    };
+
+    // -------------------- 成员变量 --------------------
+    std::atomic<Node*> head_; ///< 最新入队节点（生产者端）
+    Node* tail_;              ///< 哨兵节点（消费者端）
+};
+
+#include "MpscQueue_impl.hpp"
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include "MpscQueue.h"
+
+#include <utility>
+
+// ============================================
+// 模板方法实现（顺序与头文件 public 区一致）
+// ============================================
+
+template<typename T>
+inline MpscQueue<T>::MpscQueue()
+    : head_(new Node())
+    , tail_(head_.load(std::memory_order_relaxed)) {
+}
+
+template<typename T>
+inline MpscQueue<T>::~MpscQueue() {
+    Node* node = tail_;
+    while (node != nullptr) {
+        Node* next = node->next.load(std::memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+template<typename T>
+inline void MpscQueue<T>::push(T value) {
+    Node* node = new Node();
+    node->value.emplace(std::move(value));
+    // 先交换 head_ 占位，再链接前驱；链接前消费者看到的是“暂时为空”
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+template<typename T>
+inline std::optional<T> MpscQueue<T>::try_pop() {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return std::nullopt;
+    }
+    // next 成为新的哨兵，其元素移出后旧哨兵释放
+    std::optional<T> result = std::move(next->value);
+    next->value.reset();
+    delete tail_;
+    tail_ = next;
+    return result;
+}
+
+template<typename T>
+inline bool MpscQueue<T>::empty() const {
+    return tail_->next.load(std::memory_order_acquire) == nullptr;
+}
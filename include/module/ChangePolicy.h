@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+// ============================================
+// ChangePolicy - 数值变化判定策略
+// 决定一次更新是否算作“变化”（发出 value_changed/values_changed，触发规则计算与指令下发）：
+// 与上次推送的数值（基准值）比较，差值须超过死区；变化方向反转时死区额外加上回滞；
+// 两次推送之间至少间隔 min_interval_ms，间隔内的变化延后到间隔结束时推送最新值
+// 默认策略（全部为 0）与旧行为一致：任何不同都算变化
+// ============================================
+struct ChangePolicy {
+    int deadband = 0;            ///< 绝对死区：|新值 - 基准值| 须大于该值
+    double deadband_ratio = 0.0; ///< 相对死区：|新值 - 基准值| 须大于 |基准值| × 该比例（如 0.05 表示 5%）
+    int hysteresis = 0;          ///< 回滞：变化方向与上次推送的方向相反时，死区额外增加该值
+    int min_interval_ms = 0;     ///< 两次推送之间的最小间隔（毫秒）
+
+    /// @brief 是否为默认策略（任何不同都算变化）
+    /// @return 默认策略返回 true
+    inline bool is_default() const {
+        return deadband == 0 && deadband_ratio == 0.0 && hysteresis == 0 && min_interval_ms == 0;
+    }
+
+    /// @brief 判断数值相对基准值的偏离是否超过死区（不考虑最小间隔）
+    /// @param reference 基准值（上次推送的数值）
+    /// @param value 最新数值
+    /// @param last_direction 上次推送的变化方向（1 上升，-1 下降，0 尚无）
+    /// @return 超过死区返回 true
+    inline bool exceeds(int reference, int value, int last_direction) const {
+        int64_t delta = static_cast<int64_t>(value) - reference;
+        if (delta == 0) {
+            return false;
+        }
+        // 两种死区取较大者；相对死区以基准值为尺度，基准值为 0 时只有绝对死区生效
+        double threshold = std::max(static_cast<double>(deadband),
+            std::abs(static_cast<double>(reference)) * deadband_ratio);
+        int direction = delta > 0 ? 1 : -1;
+        if (last_direction != 0 && direction != last_direction) {
+            threshold += hysteresis;
+        }
+        return static_cast<double>(std::llabs(delta)) > threshold;
+    }
+};
+
+// ============================================
+// ChangeState - 数值变化判定状态（随 ModuleValue 保存，仅在 ModuleManager 锁内读写）
+// ============================================
+struct ChangeState {
+    int reference_value = 0;  ///< 基准值（上次推送的数值，首次获取时为首个数值）
+    int64_t reference_ns = 0; ///< 基准值的时刻（steady_clock 纳秒）
+    int direction = 0;        ///< 上次推送的变化方向（1 上升，-1 下降，0 尚无）
+    bool pending = false;     ///< 是否有因最小间隔而延后的变化
+};
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ============================================
+// GsiListener - CS2 Game State Integration 本地 HTTP 接收端（单例）
+// 仅监听 127.0.0.1，接收 CS2 以 HTTP POST 推送的 GSI JSON，按 Content-Length 分帧（支持同一连接连续请求）
+// 负载以单遍流式解析（不构建 DOM、不复制字符串），按 GSI 路径绑定表直接取出数值，
+// 整批经 ModuleManager::push_values 写入数值槽位并推送变化（推送驱动，无需轮询数据源）
+// ============================================
+class GsiListener : public QObject {
+    Q_OBJECT
+
+public:
+    // -------------------- 常量 --------------------
+    static constexpr quint16 DEFAULT_PORT = 3000;            ///< 默认监听端口（与 CS2 GSI 配置中的 uri 一致）
+    static constexpr qint64 MAX_REQUEST_BYTES = 1 << 20;     ///< 单个请求（含请求头）的最大字节数
+
+    // -------------------- 单例 --------------------
+    /// @brief 获取单例实例
+    static GsiListener& instance();
+
+    // -------------------- 监听控制 --------------------
+    /// @brief 在 127.0.0.1 上开始监听（已在监听时先停止）
+    /// @param port 监听端口
+    /// @return 成功返回 true
+    bool start(quint16 port = DEFAULT_PORT);
+
+    /// @brief 停止监听并断开所有连接
+    void stop();
+
+    /// @brief 是否正在监听
+    /// @return 监听中返回 true
+    bool is_listening() const;
+
+    /// @brief 获取实际监听端口
+    /// @return 端口号，未监听返回 0
+    quint16 get_port() const;
+
+    // -------------------- 配置 --------------------
+    /// @brief 设置鉴权令牌（与 CS2 GSI 配置中的 auth.token 对应，为空则不校验）
+    /// @param token 令牌
+    void set_auth_token(const std::string& token);
+
+    /// @brief 绑定 GSI 字段路径到模块数值（同一路径可重复绑定到多个数值）
+    /// @param path 点分隔的 JSON 路径（如 "player.state.health"）
+    /// @param value_id 模块数值 ID（如 "health"）
+    void add_binding(const std::string& path, const std::string& value_id);
+
+    // -------------------- 解析 --------------------
+    /// @brief 解析一个 GSI 负载并推送绑定的数值（HTTP 请求体，也可直接调用以回放）
+    /// @param body JSON 文本
+    /// @return 成功返回 true，JSON 格式错误或鉴权令牌不匹配返回 false
+    bool ingest(std::string_view body);
+
+signals:
+    /// @brief 成功处理一个负载后发出
+    /// @param value_count 负载中取到的绑定数值个数
+    void payload_received(int value_count);
+
+private slots:
+    /// @brief 接受新连接
+    void on_new_connection();
+
+private:
+    // -------------------- 构造/析构（单例私有）--------------------
+    GsiListener();
+    ~GsiListener() override;
+
+    // -------------------- 内部类型 --------------------
+    /// @brief 字段绑定（路径已拆分为各级键）
+    struct Binding {
+        std::vector<std::string> path; ///< 各级键
+        std::string value_id;          ///< 模块数值 ID
+    };
+
+    // -------------------- 私有辅助函数 --------------------
+    /// @brief 注册默认绑定（CS2 GSI player.state 等字段 → 默认模块数值）
+    void register_default_bindings();
+    /// @brief 处理连接上的可读数据（可能包含多个完整请求或半个请求）
+    /// @param socket 连接
+    void on_ready_read(QTcpSocket* socket);
+    /// @brief 尝试从缓冲区取出一个完整请求并处理
+    /// @param socket 连接
+    /// @param buffer 连接缓冲区
+    /// @return 处理了一个请求返回 true，数据不足或连接已关闭返回 false
+    bool handle_request(QTcpSocket* socket, QByteArray& buffer);
+    /// @brief 发送 HTTP 响应（无响应体）
+    /// @param socket 连接
+    /// @param status 状态码
+    /// @param reason 状态描述
+    /// @param close 发送后是否关闭连接
+    void respond(QTcpSocket* socket, int status, const char* reason, bool close);
+
+    // -------------------- 成员变量 --------------------
+    QTcpServer* server_ = nullptr;                           ///< 监听服务器
+    std::unordered_map<QTcpSocket*, QByteArray> buffers_;    ///< 连接 → 未处理的接收数据
+    std::vector<Binding> bindings_;                          ///< 字段绑定表
+    std::string auth_token_;                                 ///< 鉴权令牌（为空不校验）
+    std::vector<std::pair<std::string, int>> updates_;       ///< 本次负载取到的数值（复用缓冲）
+};
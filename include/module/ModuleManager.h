@@ -6,25 +6,44 @@
 #pragma once
 
 #include "Module.h"
+#include "MpscQueue.h"
+#include "TimerWheel.h"
+#include "ValueHistory.h"
+#include "ValueTrace.h"
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // ============================================
 // ModuleManager - 数值模块管理器（单例）
-// 负责模块注册、周期设置、以最短周期为基准的调度查询与数值变化推送
+// 负责模块注册、周期设置、基于分层时间轮的调度查询与数值变化推送
+// 每个数值按自身周期（任意毫秒数）与相位偏移独立调度，定时器仅在最近的到期时刻唤醒并只查询到期数值
 // ============================================
 class ModuleManager : public QObject {
     Q_OBJECT
 
 public:
+    // -------------------- 常量 --------------------
+    static constexpr int DEFAULT_ADAPTIVE_IDLE_POLLS = 8;        ///< 自适应轮询：连续未变化多少次轮询后退避一次
+    static constexpr int DEFAULT_ADAPTIVE_MAX_PERIOD_MS = 8000;  ///< 自适应轮询：退避周期上限（毫秒）
+
     // -------------------- 单例 --------------------
     /// @brief 获取单例实例
     static ModuleManager& instance();
@@ -33,6 +52,20 @@ public:
     /// @brief 注册默认模块（CS2 GSI）并启动周期调度器
     void init();
 
+    // -------------------- 模块注册 --------------------
+    /// @brief 注册模块（模块名与数值 ID 均须全局唯一，注册后数值加入调度并发出 values_registered）
+    /// @param module 模块对象（含其数值）
+    /// @return 成功返回 true，模块名重复或数值 ID 与已注册数值冲突返回 false
+    /// @note 会使之前通过 get_module/get_value 取得的指针失效
+    bool register_module(const Module& module);
+
+    /// @brief 向已注册模块追加数值（注册后数值加入调度并发出 values_registered）
+    /// @param module_name 模块名称
+    /// @param value 数值对象
+    /// @return 成功返回 true，模块不存在或数值 ID 已存在返回 false
+    /// @note 会使之前通过 get_value 取得的该模块数值指针失效
+    bool add_value(const std::string& module_name, const ModuleValue& value);
+
     // -------------------- 模块查询 --------------------
     /// @brief 获取所有模块名称
     /// @return 模块名称列表
@@ -54,41 +87,130 @@ public:
     /// @return 最小周期毫秒数，模块不存在返回 1000
     int get_module_min_period_ms(const std::string& module_name) const;
 
-    /// @brief 按数值 ID 全局查找所在模块（跨模块遍历）
+    /// @brief 按数值 ID 全局查找所在模块（经数值索引 value_index_ 哈希查找）
     /// @param value_id 数值 ID
     /// @return 模块名称，未找到返回空字符串
     std::string find_module_by_value_id(const std::string& value_id) const;
 
+    /// @brief 按数值 ID 获取数值槽位（供规则引擎预绑定 {id:xxx} 占位符，之后无锁读取）
+    /// @param value_id 数值 ID
+    /// @return 数值槽位，未找到返回 nullptr
+    std::shared_ptr<const ModuleValueSlot> find_value_slot(const std::string& value_id) const;
+
+    /// @brief 按数值 ID 获取数值历史（供规则与控件无锁读取窗口统计/最近样本）
+    /// @param value_id 数值 ID
+    /// @return 数值历史，未找到返回 nullptr
+    std::shared_ptr<const ValueHistory> find_value_history(const std::string& value_id) const;
+
+    /// @brief 获取数值的实际调度周期（自适应轮询退避后可能大于查询周期）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @return 实际调度周期毫秒数，数值不存在返回 0
+    int get_effective_period_ms(const std::string& module_name, const std::string& value_id) const;
+
     /// @brief 获取挂载到指定通道的模块名称列表
     /// @param channel 通道（"A"/"B"）
     /// @return 模块名称列表
     std::vector<std::string> get_modules_for_channel(const std::string& channel) const;
 
     // -------------------- 周期设置 --------------------
-    /// @brief 设置单个数值的查询周期（设置后自动重建调度器）
+    /// @brief 设置单个数值的查询周期（仅重新调度该数值，其他数值的相位不受影响）
     /// @param module_name 模块名称
     /// @param value_id 数值 ID
     /// @param period 新的查询周期
     void set_value_period(const std::string& module_name, const std::string& value_id,
         QueryPeriod period);
 
-    /// @brief 统一设置模块内所有数值的查询周期（设置后自动重建调度器）
+    /// @brief 设置单个数值的查询周期为任意毫秒数（仅重新调度该数值）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @param period_ms 周期毫秒数（小于 ModuleValue::MIN_PERIOD_MS 时取最小值）
+    void set_value_period_ms(const std::string& module_name, const std::string& value_id, int period_ms);
+
+    /// @brief 设置单个数值的调度相位偏移（同周期数值错开查询以分散负载，仅重新调度该数值）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @param phase_ms 相位偏移毫秒数（按周期取模）
+    void set_value_phase_ms(const std::string& module_name, const std::string& value_id, int phase_ms);
+
+    /// @brief 统一设置模块内所有数值的查询周期（仅重新调度该模块的数值）
     /// @param module_name 模块名称
     /// @param period 新的查询周期
     void set_module_period(const std::string& module_name, QueryPeriod period);
 
-    /// @brief 统一设置所有模块所有数值的查询周期（模块页统一入口，自动重建调度器）
+    /// @brief 统一设置所有模块所有数值的查询周期（模块页统一入口，重新调度全部数值）
     /// @param period 新的查询周期
     void set_all_period(QueryPeriod period);
 
+    // -------------------- 自适应轮询 --------------------
+    /// @brief 设置自适应轮询：连续 idle_polls 次轮询未变化的数值调度周期翻倍（不超过 max_period_ms），
+    ///        数值变化或被新启用的规则引用时恢复为查询周期；关闭时所有数值立即恢复查询周期
+    /// @param enabled 是否启用
+    /// @param idle_polls 退避前连续未变化的轮询次数（至少 1）
+    /// @param max_period_ms 退避周期上限（毫秒，小于查询周期的数值不退避）
+    void set_adaptive_polling(bool enabled, int idle_polls = DEFAULT_ADAPTIVE_IDLE_POLLS,
+        int max_period_ms = DEFAULT_ADAPTIVE_MAX_PERIOD_MS);
+
+    /// @brief 是否启用自适应轮询
+    /// @return 启用返回 true
+    bool is_adaptive_polling() const;
+
+    /// @brief 将指定数值恢复为查询周期并清零未变化计数（规则启用时调用，使其引用的数值立即以最快周期刷新）
+    /// @param value_ids 数值 ID 列表（未注册的 ID 忽略）
+    void reset_adaptive_periods(const std::vector<std::string>& value_ids);
+
+    // -------------------- 变化判定 --------------------
+    /// @brief 设置单个数值的变化判定策略（死区/回滞/最小间隔，在发出 value_changed 之前判定）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @param policy 变化判定策略
+    void set_value_change_policy(const std::string& module_name, const std::string& value_id,
+        const ChangePolicy& policy);
+
+    // -------------------- 历史设置 --------------------
+    /// @brief 设置数值历史的内存预算与统计窗口（重建所有数值的历史，之后注册的数值同样生效）
+    /// @param memory_budget 每个数值的内存预算（字节）
+    /// @param window_ms 窗口统计跨度（毫秒）
+    void set_history_options(size_t memory_budget, int window_ms);
+
+    // -------------------- 轨迹录制 --------------------
+    /// @brief 开始录制数值轨迹（之后每次写回的数值以 (时刻, 数值 ID, 数值) 追加到二进制轨迹文件，正在录制时先结束旧文件）
+    /// @param path 轨迹文件路径（覆盖已有文件）
+    /// @return 成功返回 true
+    bool start_trace_recording(const QString& path);
+
+    /// @brief 结束录制并截断轨迹文件到实际长度
+    void stop_trace_recording();
+
+    /// @brief 是否正在录制数值轨迹
+    /// @return 录制中返回 true
+    bool is_trace_recording() const;
+
     // -------------------- 数据源 --------------------
-    /// @brief 数据源回调类型（通过数值 ID 获取最新值）
+    /// @brief 数据源回调类型（通过数值 ID 获取最新值，逐个调用）
     using DataSource = std::function<int(const std::string& value_id)>;
 
-    /// @brief 设置数据源（默认使用模拟数据源，后续可替换为真实 GSI 数据）
+    /// @brief 批量拉取结果
+    enum class FetchStatus {
+        READY,    ///< 已填充输出（个别数值无数据时对应项保持 std::nullopt）
+        NOT_READY ///< 数据尚未就绪（本次忽略，数值保持原状态，下次到期时再拉取）
+    };
+
+    /// @brief 批量数据源回调类型（一次拉取全部到期数值，须非阻塞）
+    /// @param value_ids 到期数值 ID 列表
+    /// @param out 输出：与 value_ids 一一对应，调用前均为 std::nullopt
+    /// @return 拉取结果
+    using BatchDataSource = std::function<FetchStatus(const std::vector<std::string>& value_ids,
+        std::span<std::optional<int>> out)>;
+
+    /// @brief 设置逐值数据源（内部包装为批量数据源，默认无数据源，后续可替换为真实 GSI 数据）
     /// @param source 数据源回调
     void set_data_source(DataSource source);
 
+    /// @brief 设置批量数据源（每次调度唤醒只调用一次，且在锁外调用）
+    /// @param source 批量数据源回调，为空则移除数据源
+    void set_batch_data_source(BatchDataSource source);
+
     // -------------------- 查询 --------------------
     /// @brief 手动查询指定数值（立即查询，若变化则推送）
     /// @param module_name 模块名称
@@ -96,25 +218,85 @@ public:
     /// @return 查询到的数值，数值不存在返回 0
     int query_value(const std::string& module_name, const std::string& value_id);
 
+    /// @brief 发布单个数值（推送式数据源入口，任意线程调用，无锁入队并打上时间戳）
+    /// @param value_id 数值 ID（未注册的 ID 在消费时忽略）
+    /// @param value 最新值
+    /// @note 收到过推送的数值转为推送驱动，不再由周期调度器轮询（直到 restore_polling）；
+    ///       队列在 ModuleManager 所在线程的下一轮事件循环中整批消费，同批变化合并为一次 values_changed
+    void publish(const std::string& value_id, int value);
+
+    /// @brief 无锁发布数值（按数值键，任意线程；省去 ID 字符串的拷贝与消费时的哈希查找，供高频数据源使用）
+    /// @param value_key 数值键（由 find_value_key 取得，数值生命周期内不变）
+    /// @param value 最新值
+    void publish_by_key(uint32_t value_key, int value);
+
+    /// @brief 按数值 ID 获取数值键（高频数据源预先解析一次后按键发布）
+    /// @param value_id 数值 ID
+    /// @return 数值键，未找到返回 std::nullopt
+    std::optional<uint32_t> find_value_key(std::string_view value_id) const;
+
+    /// @brief 发布一批数值（同一时间戳；在 ModuleManager 所在线程调用时立即消费，不等待事件循环）
+    /// @param values (数值 ID, 最新值) 列表
+    /// @param take_over 是否接管这些数值（true 转为推送驱动并停止轮询，供持续推送的数据源使用；false 仅写入样本，如轨迹回放）
+    /// @param timestamp_ns 数值产生时刻（steady_clock 纳秒，为 0 时取当前时刻）
+    void push_values(const std::vector<std::pair<std::string, int>>& values, bool take_over,
+        int64_t timestamp_ns = 0);
+
+    /// @brief 所有推送驱动的数值恢复周期轮询（推送数据源停止时调用）
+    void restore_polling();
+
+    /// @brief 重置所有数值的历史与变化判定状态（以当前数值为基准，丢弃延后的变化；轨迹回放结束时调用）
+    void reset_value_states();
+
     /// @brief 获取当前调度基准周期（所有数值中的最短查询周期）
     /// @return 基准周期毫秒数
     int get_base_period_ms() const;
 
 signals:
-    /// @brief 数值变化时发出（用于触发规则计算与界面刷新）
+    /// @brief 单个数值变化时发出（用于界面刷新）
     /// @param module_name 模块名称
     /// @param value_id 数值 ID
     /// @param new_value 最新数值
     void value_changed(const QString& module_name, const QString& value_id, int new_value);
 
+    /// @brief 一个调度周期内所有数值变化汇总后发出一次（规则引擎按批次合并计算）
+    /// @param value_ids 本周期发生变化的数值 ID 列表（去重）
+    void values_changed(const QStringList& value_ids);
+
     /// @brief 查询周期设置变化时发出（用于刷新界面周期显示）
     void period_changed();
 
+    /// @brief 模块数值注册完成时发出（用于规则引擎重新绑定数值槽位）
+    void values_registered();
+
+    /// @brief 数值实际调度周期因自适应轮询退避或恢复而变化时发出（用于界面显示）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @param effective_period_ms 实际调度周期（毫秒）
+    void effective_period_changed(const QString& module_name, const QString& value_id, int effective_period_ms);
+
 private slots:
-    /// @brief 调度定时器触发（按基准周期执行到期数值的查询）
+    /// @brief 调度定时器触发（推进时间轮，仅查询到期数值并按各自周期重新调度）
     void on_timer_tick();
 
+    /// @brief 延后变化定时器触发（推送因最小间隔而延后、且间隔已满的变化）
+    void on_change_timer();
+
 private:
+    // -------------------- 内部类型 --------------------
+    /// @brief 发布队列元素
+    struct PublishedValue {
+        std::string value_id;              ///< 数值 ID（按数值键发布时为空）
+        uint32_t value_key = NO_VALUE_KEY; ///< 数值键（按 ID 发布时为 NO_VALUE_KEY）
+        int value = 0;                     ///< 最新值
+        int64_t timestamp_ns = 0;          ///< 发布时刻（steady_clock 纳秒）
+        bool take_over = true;             ///< 是否转为推送驱动（停止轮询）
+    };
+
+    // -------------------- 常量 --------------------
+    static constexpr uint32_t NO_VALUE_KEY = UINT32_MAX;             ///< 无数值键（PublishedValue 按 ID 发布）
+    static constexpr int64_t PUBLISH_LATENCY_BUDGET_NS = 10'000'000; ///< 发布到消费的延迟超过该值（10ms）时记录调试日志
+
     // -------------------- 构造/析构（单例私有）--------------------
     ModuleManager();
     ~ModuleManager() override;
@@ -122,19 +304,89 @@ private:
     // -------------------- 私有辅助函数 --------------------
     /// @brief 注册默认模块（CS2 GSI 数值，参照官方 GSI 规范）
     void register_default_modules();
-    /// @brief 重建调度器（以所有数值中最短查询周期为基准）
-    void rebuild_scheduler();
-    /// @brief 查询单个数值并检测变化（需已持有锁）
-    /// @param module 模块引用
+    /// @brief 为新注册的数值分配调度键并加入时间轮（需已持有锁）
+    /// @param module_idx 模块下标
+    /// @param value_idx 数值下标
+    void track_value_locked(size_t module_idx, size_t value_idx);
+    /// @brief 按数值当前周期与相位重新调度（需已持有锁，旧调度惰性失效）
+    /// @param module_idx 模块下标
+    /// @param value_idx 数值下标
+    void schedule_value_locked(size_t module_idx, size_t value_idx);
+    /// @brief 按轮询结果调整自适应退避周期（需已持有锁，恢复查询周期时立即重新调度）
+    /// @param module_idx 模块下标
+    /// @param value_idx 数值下标
+    /// @param unchanged 本次轮询数值是否与上次相同
+    /// @return 实际调度周期是否变化
+    bool adapt_period_locked(size_t module_idx, size_t value_idx, bool unchanged);
+    /// @brief 按时间轮最早到期时刻设置单次定时器（需已持有锁）
+    void arm_timer_locked();
+    /// @brief 重新计算基准周期（所有数值中最短查询周期，仅用于界面显示，需已持有锁）
+    void update_base_period_locked();
+    /// @brief 注册模块并建立索引（需已持有锁）
+    /// @param module 模块对象
+    /// @return 成功返回 true，模块名或数值 ID 冲突返回 false
+    bool register_module_locked(const Module& module);
+    /// @brief 按模块名查找模块下标（需已持有锁）
+    /// @param module_name 模块名称
+    /// @return 模块下标，不存在返回 -1
+    int find_module_locked(const std::string& module_name) const;
+    /// @brief 按模块名与数值 ID 查找数值下标（需已持有锁）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @return (模块下标, 数值下标)，不存在或不属于该模块返回 std::nullopt
+    std::optional<std::pair<size_t, size_t>> find_value_index_locked(const std::string& module_name,
+        const std::string& value_id) const;
+    /// @brief 按模块名与数值 ID 查找数值（需已持有锁）
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @return 数值指针，不存在或不属于该模块返回 nullptr
+    ModuleValue* find_value_locked(const std::string& module_name, const std::string& value_id);
+    const ModuleValue* find_value_locked(const std::string& module_name, const std::string& value_id) const;
+    /// @brief 写入拉取/推送到的数值并检测变化（需已持有锁）
     /// @param value 数值引用
-    /// @return 是否发生变化
-    bool query_value_locked(Module& module, ModuleValue& value);
+    /// @param new_value 最新数值
+    /// @param timestamp_ns 数值产生时刻（steady_clock 纳秒）
+    /// @return 是否推送变化（已有历史值且按变化判定策略算作变化）
+    bool apply_value_locked(ModuleValue& value, int new_value, int64_t timestamp_ns);
+    /// @brief 按变化判定策略判断当前数值相对基准值是否应推送（需已持有锁，推送时更新基准值）
+    /// @param value 数值引用（已写入最新数值）
+    /// @param now_ns 判定时刻（steady_clock 纳秒）
+    /// @return 应推送返回 true；因最小间隔延后时标记待推送并设置延后变化定时器
+    bool evaluate_change_locked(ModuleValue& value, int64_t now_ns);
+    /// @brief 设置延后变化定时器（需已持有锁，已设置更早的到期时刻时不变）
+    /// @param ready_ns 延后变化可推送的时刻（steady_clock 纳秒）
+    void arm_change_timer_locked(int64_t ready_ns);
+    /// @brief 消费发布队列中的全部数值（仅 ModuleManager 所在线程）
+    void drain_published();
+    /// @brief 发出数值变化信号：逐个发出 value_changed，再整批发出一次 values_changed（不可持锁调用）
+    /// @param changes (模块名称, 数值 ID, 最新值) 列表
+    void emit_changes(const std::vector<std::tuple<std::string, std::string, int>>& changes);
 
     // -------------------- 成员变量 --------------------
     std::vector<Module> modules_;         ///< 模块列表
+    std::unordered_map<std::string, size_t> module_index_; ///< 模块名 → 模块下标
+    std::unordered_map<std::string, std::pair<size_t, size_t>> value_index_; ///< 数值 ID → (模块下标, 数值下标)
     mutable std::mutex mutex_;            ///< 保护模块数据
-    QTimer* timer_ = nullptr;             ///< 调度定时器
-    int tick_count_ = 0;                  ///< 调度计数（以基准周期递增）
-    int base_period_ms_ = 1000;           ///< 基准周期（毫秒）
-    DataSource data_source_;              ///< 数据源回调
+    QTimer* timer_ = nullptr;             ///< 调度定时器（单次触发，按最早到期时刻重设）
+    QTimer* change_timer_ = nullptr;      ///< 延后变化定时器（单次触发，按最早可推送时刻重设）
+    int64_t change_due_ns_ = 0;           ///< 延后变化定时器的到期时刻（steady_clock 纳秒，0 表示未设置）
+    QElapsedTimer clock_;                 ///< 调度时钟（时间轮刻度 = 启动以来的毫秒数）
+    TimerWheel wheel_;                    ///< 调度时间轮（键 → schedule_keys_ 下标）
+    std::vector<std::pair<size_t, size_t>> schedule_keys_; ///< 调度键 → (模块下标, 数值下标)
+    std::vector<std::vector<uint32_t>> value_keys_;        ///< 模块下标 → 各数值的调度键
+    std::vector<TimerWheel::Expired> expired_;             ///< 到期定时器缓冲（复用，避免每次触发分配）
+    std::vector<uint32_t> due_keys_;                       ///< 本次到期数值的调度键（仅调度定时器所在线程使用）
+    std::vector<std::string> due_ids_;                     ///< 本次到期数值 ID（批量数据源入参）
+    std::vector<std::optional<int>> fetched_;              ///< 本次拉取结果（批量数据源出参）
+    int base_period_ms_ = 1000;           ///< 基准周期（最短查询周期，毫秒）
+    bool adaptive_polling_ = false;       ///< 是否启用自适应轮询
+    int adaptive_idle_polls_ = DEFAULT_ADAPTIVE_IDLE_POLLS;       ///< 退避前连续未变化的轮询次数
+    int adaptive_max_period_ms_ = DEFAULT_ADAPTIVE_MAX_PERIOD_MS; ///< 退避周期上限（毫秒）
+    ValueTraceWriter trace_writer_;       ///< 数值轨迹录制（持锁写入）
+    size_t history_budget_ = ValueHistory::DEFAULT_MEMORY_BUDGET; ///< 数值历史内存预算（字节/数值）
+    int history_window_ms_ = ValueHistory::DEFAULT_WINDOW_MS;     ///< 数值历史统计窗口（毫秒）
+    std::shared_ptr<const BatchDataSource> data_source_; ///< 批量数据源（锁内取出共享指针，锁外调用）
+    bool initialized_ = false;            ///< 是否已注册默认模块
+    MpscQueue<PublishedValue> publish_queue_;       ///< 发布队列（任意线程生产，ModuleManager 所在线程消费）
+    std::atomic<bool> drain_scheduled_{ false };   ///< 是否已投递队列消费（避免每次发布都投递事件）
 };
\ No newline at end of file
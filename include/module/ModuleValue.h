@@ -5,6 +5,13 @@
 
 #pragma once
 
+#include "ChangePolicy.h"
+#include "ModuleValueSlot.h"
+#include "ValueHistory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 // ============================================
@@ -65,12 +72,18 @@ inline QueryPeriod query_period_from_text(const std::string& text) {
 
 // ============================================
 // ModuleValue - 单个可查询数值
-// 描述一个数值的名称、ID、查询周期与上次查询结果
+// 描述一个数值的名称、ID、查询周期（任意毫秒数与相位偏移）与上次查询结果
+// 查询结果保存在共享的 ModuleValueSlot 中（拷贝共享同一槽位），规则引擎可预先绑定槽位无锁读取
+// 每次更新同时追加到共享的 ValueHistory（拷贝共享同一历史），规则与控件可无锁读取窗口统计
+// 是否推送变化由 ChangePolicy（死区/回滞/最小间隔）判定，槽位与历史始终保存最新数值
 // ============================================
 class ModuleValue {
 public:
+    // -------------------- 常量 --------------------
+    static constexpr int MIN_PERIOD_MS = 10; ///< 最短查询周期（毫秒）
+
     // -------------------- 构造/析构 --------------------
-    ModuleValue() = default;
+    ModuleValue();
 
     /// @brief 构造函数
     /// @param id 数值 ID（参照 CS2 GSI 规范，如 "health"）
@@ -89,9 +102,25 @@ public:
     /// @return 数值名称
     inline const std::string& get_name() const { return name_; }
 
-    /// @brief 获取查询周期
-    /// @return 查询周期枚举
-    inline QueryPeriod get_query_period() const { return query_period_; }
+    /// @brief 获取查询周期（预设档位）
+    /// @return 查询周期枚举，周期不是预设档位时返回 SECOND
+    inline QueryPeriod get_query_period() const { return query_period_from_ms(period_ms_); }
+
+    /// @brief 获取查询周期（毫秒）
+    /// @return 周期毫秒数
+    inline int get_period_ms() const { return period_ms_; }
+
+    /// @brief 获取实际调度周期（毫秒，自适应轮询退避后可能大于查询周期）
+    /// @return 实际调度周期毫秒数
+    inline int get_effective_period_ms() const { return std::max(period_ms_, backoff_period_ms_); }
+
+    /// @brief 获取连续未变化的轮询次数（自适应轮询退避计数，每次退避后清零）
+    /// @return 连续未变化次数
+    inline int get_unchanged_polls() const { return unchanged_polls_; }
+
+    /// @brief 获取调度相位偏移（毫秒，数值在满足 t ≡ phase (mod period) 的时刻被查询）
+    /// @return 相位偏移毫秒数
+    inline int get_phase_ms() const { return phase_ms_; }
 
     /// @brief 获取底层字段名（如 m_iHealth，用于界面展示）
     /// @return 底层字段名
@@ -99,30 +128,101 @@ public:
 
     /// @brief 获取上次查询到的数值
     /// @return 上次查询值
-    inline int get_last_value() const { return last_value_; }
+    inline int get_last_value() const { return slot_->value(); }
 
     /// @brief 是否已获取过数值
     /// @return 已获取返回 true
-    inline bool get_has_value() const { return has_value_; }
+    inline bool get_has_value() const { return slot_->has_value(); }
+
+    /// @brief 是否为推送驱动（收到过 ModuleManager::publish 推送，不再参与周期调度）
+    /// @return 推送驱动返回 true
+    inline bool get_push_driven() const { return push_driven_; }
+
+    /// @brief 获取最近一次更新的时间戳（steady_clock 纳秒；推送为发布时刻，轮询为拉取时刻）
+    /// @return 时间戳，未更新过返回 0
+    inline int64_t get_last_update_ns() const { return last_update_ns_; }
+
+    /// @brief 获取数值槽位（地址在数值生命周期内稳定，可跨线程无锁读取）
+    /// @return 数值槽位
+    inline std::shared_ptr<const ModuleValueSlot> get_slot() const { return slot_; }
+
+    /// @brief 获取数值历史（可跨线程无锁读取，重新设置历史参数后旧对象保持有效但不再更新）
+    /// @return 数值历史
+    inline std::shared_ptr<const ValueHistory> get_history() const { return history_; }
+
+    /// @brief 获取变化判定策略
+    /// @return 变化判定策略
+    inline const ChangePolicy& get_change_policy() const { return change_policy_; }
+
+    /// @brief 获取变化判定状态（基准值、方向与是否有延后的变化）
+    /// @return 变化判定状态
+    inline ChangeState& get_change_state() { return change_state_; }
+    inline const ChangeState& get_change_state() const { return change_state_; }
 
     // -------------------- 公共接口（属性设置）--------------------
-    /// @brief 设置查询周期
+    /// @brief 设置查询周期（预设档位，同时取消自适应轮询退避）
     /// @param period 新的查询周期
-    inline void set_query_period(QueryPeriod period) { query_period_ = period; }
+    inline void set_query_period(QueryPeriod period) { set_period_ms(query_period_to_ms(period)); }
+
+    /// @brief 设置查询周期（任意毫秒数，小于 MIN_PERIOD_MS 时取 MIN_PERIOD_MS，同时取消自适应轮询退避）
+    /// @param period_ms 周期毫秒数
+    inline void set_period_ms(int period_ms) {
+        period_ms_ = std::max(period_ms, MIN_PERIOD_MS);
+        backoff_period_ms_ = 0;
+        unchanged_polls_ = 0;
+    }
+
+    /// @brief 设置退避后的调度周期（毫秒，不大于查询周期时等同于查询周期）
+    /// @param period_ms 退避周期毫秒数，0 表示取消退避
+    inline void set_backoff_period_ms(int period_ms) { backoff_period_ms_ = std::max(period_ms, 0); }
+
+    /// @brief 设置连续未变化的轮询次数
+    /// @param count 次数
+    inline void set_unchanged_polls(int count) { unchanged_polls_ = count; }
+
+    /// @brief 设置调度相位偏移（按周期取模，使同周期数值错开查询）
+    /// @param phase_ms 相位偏移毫秒数
+    inline void set_phase_ms(int phase_ms) { phase_ms_ = std::max(phase_ms, 0); }
 
     /// @brief 记录最新查询到的数值
     /// @param value 查询到的数值
-    inline void set_last_value(int value) {
-        last_value_ = value;
-        has_value_ = true;
-    }
+    inline void set_last_value(int value) { slot_->store(value); }
+
+    /// @brief 设置是否为推送驱动
+    /// @param push_driven 推送驱动
+    inline void set_push_driven(bool push_driven) { push_driven_ = push_driven; }
+
+    /// @brief 设置变化判定策略（基准值保持不变，下一次更新起按新策略判定）
+    /// @param policy 变化判定策略
+    inline void set_change_policy(const ChangePolicy& policy) { change_policy_ = policy; }
+
+    /// @brief 记录最近一次更新的时间戳
+    /// @param timestamp_ns 时间戳（steady_clock 纳秒）
+    inline void set_last_update_ns(int64_t timestamp_ns) { last_update_ns_ = timestamp_ns; }
+
+    /// @brief 追加一个历史样本（同一数值只能有一个写入方）
+    /// @param timestamp_ns 时间戳（steady_clock 纳秒）
+    /// @param value 数值
+    inline void record_history(int64_t timestamp_ns, int value) { history_->push(timestamp_ns, value); }
+
+    /// @brief 以新的内存预算与统计窗口重建历史（丢弃已有样本）
+    /// @param memory_budget 内存预算（字节）
+    /// @param window_ms 统计窗口（毫秒）
+    void reset_history(size_t memory_budget, int window_ms);
 
 private:
     // -------------------- 成员变量 --------------------
     std::string id_;                                        ///< 数值 ID（如 "health"）
     std::string name_;                                      ///< 数值中文名称（如 "当前血量"）
-    QueryPeriod query_period_ = QueryPeriod::SECOND;        ///< 查询周期
+    int period_ms_ = query_period_to_ms(QueryPeriod::SECOND); ///< 查询周期（毫秒）
+    int phase_ms_ = 0;                                      ///< 调度相位偏移（毫秒）
+    int backoff_period_ms_ = 0;                             ///< 自适应轮询退避周期（毫秒，0 表示未退避）
+    int unchanged_polls_ = 0;                               ///< 连续未变化的轮询次数
+    bool push_driven_ = false;                              ///< 是否为推送驱动
+    int64_t last_update_ns_ = 0;                            ///< 最近一次更新的时间戳（steady_clock 纳秒）
     std::string field_;                                     ///< 底层字段名（如 "m_iHealth"）
-    int last_value_ = 0;                                    ///< 上次查询到的数值
-    bool has_value_ = false;                                ///< 是否已获取过数值
+    std::shared_ptr<ModuleValueSlot> slot_;                 ///< 数值槽位（上次查询到的数值与是否已获取）
+    std::shared_ptr<ValueHistory> history_;                 ///< 数值历史（时间序列环形缓冲）
+    ChangePolicy change_policy_;                            ///< 变化判定策略（死区/回滞/最小间隔）
+    ChangeState change_state_;                              ///< 变化判定状态
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+// ============================================
+// ModuleValueSlot - 数值槽位
+// 保存单个数值的最新值与“是否已获取”标志，两者打包在一个 64 位原子量中，
+// 写入方（模块调度）与读取方（规则计算）均无需加锁，读取总能得到一致的值与标志
+// ============================================
+class ModuleValueSlot {
+public:
+    // -------------------- 构造/析构 --------------------
+    ModuleValueSlot() = default;
+    ModuleValueSlot(const ModuleValueSlot&) = delete;
+    ModuleValueSlot& operator=(const ModuleValueSlot&) = delete;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 写入最新数值（同时标记为已获取）
+    /// @param value 最新数值
+    inline void store(int value) {
+        packed_.store(HAS_VALUE_BIT | static_cast<uint32_t>(value), std::memory_order_release);
+    }
+
+    /// @brief 清除数值（恢复为未获取状态）
+    inline void clear() { packed_.store(0, std::memory_order_release); }
+
+    /// @brief 读取数值
+    /// @return 最新数值，未获取过返回 std::nullopt
+    inline std::optional<int> load() const {
+        uint64_t packed = packed_.load(std::memory_order_acquire);
+        if (!(packed & HAS_VALUE_BIT)) {
+            return std::nullopt;
+        }
+        return static_cast<int>(static_cast<uint32_t>(packed));
+    }
+
+    /// @brief 是否已获取过数值
+    inline bool has_value() const {
+        return (packed_.load(std::memory_order_acquire) & HAS_VALUE_BIT) != 0;
+    }
+
+    /// @brief 读取数值（未获取过返回 0）
+    inline int value() const {
+        return static_cast<int>(static_cast<uint32_t>(packed_.load(std::memory_order_acquire)));
+    }
+
+private:
+    // -------------------- 常量 --------------------
+    static constexpr uint64_t HAS_VALUE_BIT = uint64_t{ 1 } << 32; ///< 已获取标志位
+
+    // -------------------- 成员变量 --------------------
+    std::atomic<uint64_t> packed_{ 0 }; ///< 高 32 位为标志，低 32 位为数值
+};
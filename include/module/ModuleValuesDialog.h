@@ -46,6 +46,12 @@ private slots:
     /// @brief 周期设置变化时同步刷新所有下拉框显示
     void on_period_changed();
 
+    /// @brief 实际调度周期（自适应轮询退避/恢复）变化时更新对应标签
+    /// @param module_name 模块名称
+    /// @param value_id 数值 ID
+    /// @param effective_period_ms 实际调度周期（毫秒）
+    void on_effective_period_changed(const QString& module_name, const QString& value_id, int effective_period_ms);
+
 private:
     // -------------------- 成员变量 --------------------
     /// @brief 单个数值框的控件集合
@@ -54,6 +60,7 @@ private:
         QLabel* value_label = nullptr;       ///< 当前数值标签
         QLabel* field_label = nullptr;       ///< 底层字段名标签（小字）
         QComboBox* period_combo = nullptr;   ///< 查询周期下拉框
+        QLabel* effective_label = nullptr;   ///< 实际调度周期标签（自适应轮询退避时显示）
     };
 
     std::string module_name_;                ///< 模块名称
@@ -71,6 +78,10 @@ private:
     /// @param row 行号
     /// @param col 列号
     void create_value_box(const ModuleValue& value, QGridLayout* layout, int row, int col);
+    /// @brief 更新数值框的实际调度周期标签（与查询周期相同时隐藏）
+    /// @param box_index 数值框索引
+    /// @param effective_period_ms 实际调度周期（毫秒）
+    void update_effective_label(size_t box_index, int effective_period_ms);
     /// @brief 刷新所有数值框的当前值与周期显示
     void refresh_all_boxes();
 };
\ No newline at end of file
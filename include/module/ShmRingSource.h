@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+struct dglab_shm_ring; ///< 共享内存环头（定义见 dglab_shm_ring.h，避免在此引入平台头文件）
+
+// ============================================
+// ShmRingSource - 共享内存数值环形缓冲数据源（单例，消费者端）
+// 创建共享内存段（POSIX shm_open / Windows 命名文件映射）并初始化 dglab_shm_ring 环头，
+// 本地生产者通过 dglab_shm_ring.h 写入定长数值记录；消费线程直接读取共享内存中的记录（不拷贝、不解析 JSON），
+// 数值 ID 首次出现时解析为数值键并缓存，之后经 ModuleManager::publish_by_key 无锁发布
+// ============================================
+class ShmRingSource {
+public:
+    // -------------------- 常量 --------------------
+    static constexpr const char* DEFAULT_NAME = "dglab_values"; ///< 默认共享内存段名称
+    static constexpr uint32_t DEFAULT_CAPACITY = 4096;          ///< 默认记录槽位数
+    static constexpr int SPIN_ITERATIONS = 2000;                ///< 空闲时自旋检查次数（之后让出时间片）
+    static constexpr int YIELD_ITERATIONS = 200;                ///< 空闲时让出时间片次数（之后短暂休眠）
+    static constexpr int IDLE_SLEEP_US = 200;                   ///< 持续空闲时每次休眠的微秒数
+
+    // -------------------- 单例 --------------------
+    /// @brief 获取单例实例
+    static ShmRingSource& instance();
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 创建共享内存段并启动消费线程（已启动时先停止）
+    /// @param name 共享内存段名称（生产者以同名打开）
+    /// @param capacity 记录槽位数（向上取 2 的幂）
+    /// @return 成功返回 true
+    bool start(const std::string& name = DEFAULT_NAME, uint32_t capacity = DEFAULT_CAPACITY);
+
+    /// @brief 停止消费线程并删除共享内存段
+    void stop();
+
+    /// @brief 是否正在运行
+    /// @return 运行中返回 true
+    inline bool is_running() const { return ring_ != nullptr; }
+
+    /// @brief 获取已消费的记录数
+    /// @return 记录数
+    inline uint64_t get_consumed_count() const { return consumed_.load(std::memory_order_relaxed); }
+
+private:
+    // -------------------- 构造/析构（单例私有）--------------------
+    ShmRingSource();
+    ~ShmRingSource();
+    ShmRingSource(const ShmRingSource&) = delete;
+    ShmRingSource& operator=(const ShmRingSource&) = delete;
+
+    // -------------------- 内部常量与类型 --------------------
+    static constexpr uint32_t UNKNOWN_KEY = UINT32_MAX; ///< 未注册数值的缓存键（数值注册后重新解析）
+
+    /// @brief 支持 string_view 异构查找的字符串哈希
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    // -------------------- 私有辅助函数 --------------------
+    /// @brief 创建并映射共享内存段
+    /// @param bytes 段字节数
+    /// @return 成功返回 true
+    bool map_segment(size_t bytes);
+    /// @brief 解除映射并删除共享内存段
+    void unmap_segment();
+    /// @brief 消费线程主循环
+    void run();
+    /// @brief 消费当前可读的全部记录
+    /// @return 消费的记录数
+    size_t consume();
+    /// @brief 解析数值 ID 对应的数值键（首次查询 ModuleManager，之后命中缓存）
+    /// @param value_id 数值 ID（指向共享内存）
+    /// @return 数值键，未注册的数值返回 UNKNOWN_KEY
+    uint32_t resolve_key(std::string_view value_id);
+
+    // -------------------- 成员变量 --------------------
+    std::string name_;                         ///< 共享内存段名称
+    dglab_shm_ring* ring_ = nullptr;           ///< 环头（映射区起始地址）
+    size_t bytes_ = 0;                         ///< 映射字节数
+#ifdef _WIN32
+    void* mapping_ = nullptr;                  ///< 文件映射句柄
+#endif
+    std::thread thread_;                       ///< 消费线程
+    std::atomic<bool> running_{ false };       ///< 消费线程运行标志
+    std::atomic<uint64_t> consumed_{ 0 };      ///< 已消费记录数
+    std::atomic<bool> keys_stale_{ false };    ///< 数值键缓存是否需要重建（模块注册后置位）
+    uint64_t reported_dropped_ = 0;            ///< 上次记录日志时的丢弃数（仅消费线程）
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> keys_; ///< 数值 ID → 数值键（仅消费线程）
+};
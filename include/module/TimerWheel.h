@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// ============================================
+// TimerWheel - 分层时间轮（数值轮询调度）
+// 4 层 × 64 槽，第 L 层每槽跨 64^L 个刻度；到期时间落在哪一层由距当前刻度的远近决定，
+// 高层槽位被推进到时整体下沉（cascade）到低层，最底层槽位内的定时器在该刻度到期
+// 推进时按占用位图跳过空槽，开销与到期定时器数量（及跨越的 64 刻度边界数）成正比，与注册总数无关
+// 重新调度/取消采用惰性代际计数：仅递增键的代际号，旧条目在被推进到时丢弃
+// 刻度单位由调用方决定（ModuleManager 以毫秒为刻度）
+// ============================================
+class TimerWheel {
+public:
+    // -------------------- 类型 --------------------
+    /// @brief 到期定时器
+    struct Expired {
+        uint32_t key = 0;      ///< 定时器键（调用方定义，如数值调度下标）
+        uint64_t due_tick = 0; ///< 到期刻度（用于无漂移地计算下一次到期）
+    };
+
+    // -------------------- 常量 --------------------
+    static constexpr unsigned SLOT_BITS = 6;                         ///< 每层槽位数的位宽
+    static constexpr size_t SLOT_COUNT = size_t{ 1 } << SLOT_BITS;   ///< 每层槽位数
+    static constexpr size_t LEVEL_COUNT = 4;                         ///< 层数（可表示 2^24 个刻度的跨度）
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 清空所有定时器并将当前刻度归零
+    void clear();
+
+    /// @brief 调度（或重新调度）定时器，该键之前的调度立即失效
+    /// @param key 定时器键
+    /// @param due_tick 到期刻度（不晚于当前刻度时按下一刻度处理）
+    void schedule(uint32_t key, uint64_t due_tick);
+
+    /// @brief 取消定时器（不存在时忽略）
+    /// @param key 定时器键
+    void cancel(uint32_t key);
+
+    /// @brief 推进到指定刻度，收集期间到期的定时器（按到期刻度先后排列，到期后不再自动重排）
+    /// @param now_tick 目标刻度（早于当前刻度时不推进）
+    /// @param expired 输出：到期定时器（追加写入）
+    void advance(uint64_t now_tick, std::vector<Expired>& expired);
+
+    /// @brief 获取最早的到期刻度（用于设置下一次唤醒）
+    /// @return 最早到期刻度，无定时器返回 std::nullopt
+    std::optional<uint64_t> next_due_tick() const;
+
+    /// @brief 获取当前刻度
+    /// @return 当前刻度（已推进到的刻度）
+    inline uint64_t now_tick() const { return now_tick_; }
+
+    /// @brief 获取定时器的到期刻度
+    /// @param key 定时器键
+    /// @return 到期刻度，未调度返回 std::nullopt
+    std::optional<uint64_t> get_due_tick(uint32_t key) const;
+
+private:
+    // -------------------- 条目 --------------------
+    struct Entry {
+        uint32_t key = 0;        ///< 定时器键
+        uint32_t generation = 0; ///< 调度时的代际号（与当前代际不一致即为过期条目）
+        uint64_t due_tick = 0;   ///< 到期刻度
+    };
+
+    // -------------------- 私有辅助函数 --------------------
+    void place(const Entry& entry);                      ///< 按距当前刻度的远近放入对应层的槽位
+    void cascade(size_t level);                          ///< 将指定层当前槽位的条目下沉到低层
+    void expire_current(std::vector<Expired>& expired);  ///< 处理最底层当前槽位的到期条目
+    bool is_live(const Entry& entry) const;              ///< 条目是否仍有效（代际一致）
+
+    // -------------------- 成员变量 --------------------
+    std::array<std::array<std::vector<Entry>, SLOT_COUNT>, LEVEL_COUNT> slots_; ///< 各层槽位
+    std::array<uint64_t, LEVEL_COUNT> occupied_{};   ///< 各层槽位占用位图（可能包含仅剩过期条目的槽位）
+    std::vector<uint32_t> generations_;              ///< 键 → 当前代际号
+    std::vector<std::optional<uint64_t>> due_ticks_; ///< 键 → 当前到期刻度（未调度为空）
+    uint64_t now_tick_ = 0;                          ///< 当前刻度（不晚于此刻度的定时器均已到期）
+};
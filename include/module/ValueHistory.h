@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
+// ============================================
+// ValueHistory - 数值历史环形缓冲（单写多读，无锁）
+// 时间戳、数值与前缀和分别存放在连续数组中（按内存预算取 2 的幂容量），写入方追加样本，读取方随时无锁读取：
+//   - 样本区：读取后以写入计数校验是否被覆盖，被覆盖则重试
+//   - 窗口统计（时间窗口内的最小/最大/和/个数与最近一次差值）：写入时以单调队列增量维护，
+//     以顺序锁（seqlock）发布，读取 O(1) 且不复制样本
+//   - 任意最近 N 个样本之和：前缀和相减，O(1)
+// 写入方须唯一（ModuleManager 在持锁时写入），读取方数量不限
+// ============================================
+class ValueHistory {
+public:
+    // -------------------- 类型 --------------------
+    /// @brief 单个样本
+    struct Sample {
+        int64_t timestamp_ns = 0; ///< 时间戳（steady_clock 纳秒）
+        int value = 0;            ///< 数值
+    };
+
+    /// @brief 窗口统计（以最新样本为窗口右端）
+    struct WindowStats {
+        size_t count = 0;         ///< 窗口内样本数（0 表示无历史）
+        int min = 0;              ///< 窗口内最小值
+        int max = 0;              ///< 窗口内最大值
+        int64_t sum = 0;          ///< 窗口内数值之和
+        int64_t last_delta = 0;   ///< 最新样本与前一个样本之差（仅一个样本时为 0；以 64 位保存，差值不溢出）
+        int64_t latest_ns = 0;    ///< 最新样本时间戳
+    };
+
+    // -------------------- 常量 --------------------
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 64 * 1024; ///< 默认内存预算（字节/数值）
+    static constexpr int DEFAULT_WINDOW_MS = 1000;             ///< 默认统计窗口（毫秒）
+    static constexpr size_t MIN_CAPACITY = 16;                 ///< 最小容量（样本数）
+
+    // -------------------- 构造/析构 --------------------
+    /// @brief 构造函数
+    /// @param memory_budget 内存预算（字节，按每样本占用折算为不超过预算的 2 的幂容量，至少 MIN_CAPACITY）
+    /// @param window_ms 窗口统计的时间跨度（毫秒）
+    explicit ValueHistory(size_t memory_budget = DEFAULT_MEMORY_BUDGET, int window_ms = DEFAULT_WINDOW_MS);
+    ValueHistory(const ValueHistory&) = delete;
+    ValueHistory& operator=(const ValueHistory&) = delete;
+
+    // -------------------- 写入（仅唯一写入方）--------------------
+    /// @brief 追加样本（时间戳应单调不减）
+    /// @param timestamp_ns 时间戳（steady_clock 纳秒）
+    /// @param value 数值
+    void push(int64_t timestamp_ns, int value);
+
+    /// @brief 清空历史
+    void clear();
+
+    // -------------------- 读取（任意线程，无锁）--------------------
+    /// @brief 获取容量（槽位数，其中一个留给正在写入的样本，最多可读取 capacity - 1 个样本）
+    inline size_t capacity() const { return capacity_; }
+
+    /// @brief 获取统计窗口跨度（毫秒）
+    inline int get_window_ms() const { return static_cast<int>(window_ns_ / 1'000'000); }
+
+    /// @brief 获取当前可读取的样本数
+    size_t size() const;
+
+    /// @brief 读取最新样本
+    /// @return 最新样本，无历史返回 std::nullopt
+    std::optional<Sample> latest() const;
+
+    /// @brief 读取窗口统计（O(1)，不复制样本）
+    /// @return 窗口统计
+    WindowStats window_stats() const;
+
+    /// @brief 最近 count 个样本之和（O(1)，count 超过可用样本数时按可用样本计算）
+    /// @param count 样本个数
+    /// @return 数值之和，无历史返回 0
+    int64_t sum_recent(size_t count) const;
+
+    /// @brief 按时间先后复制最近的样本（用于波形等需要完整序列的场景）
+    /// @param out 输出缓冲（最多写入 out.size() 个）
+    /// @return 实际写入的样本数
+    size_t read_recent(std::span<Sample> out) const;
+
+private:
+    // -------------------- 私有辅助函数 --------------------
+    void evict_front();                    ///< 将最旧样本移出窗口（仅写入方）
+    void publish_stats(int64_t last_delta);    ///< 以顺序锁发布窗口统计（仅写入方）
+    inline size_t slot_of(uint64_t seq) const { return static_cast<size_t>(seq) & mask_; }
+
+    // -------------------- 成员变量（共享）--------------------
+    size_t capacity_;                                    ///< 容量（2 的幂）
+    size_t mask_;                                        ///< 容量掩码
+    int64_t window_ns_;                                  ///< 统计窗口跨度（纳秒）
+    std::unique_ptr<std::atomic<int64_t>[]> timestamps_; ///< 时间戳环
+    std::unique_ptr<std::atomic<int32_t>[]> values_;     ///< 数值环
+    std::unique_ptr<std::atomic<int64_t>[]> prefix_;     ///< 前缀和环（该样本之前的累计和）
+    std::atomic<uint64_t> head_{ 0 };                    ///< 已写入样本总数（下一个样本序号）
+    std::atomic<uint64_t> stats_seq_{ 0 };               ///< 窗口统计顺序锁（奇数表示写入中）
+    std::atomic<uint64_t> stats_count_{ 0 };             ///< 窗口统计：样本数
+    std::atomic<int32_t> stats_min_{ 0 };                ///< 窗口统计：最小值
+    std::atomic<int32_t> stats_max_{ 0 };                ///< 窗口统计：最大值
+    std::atomic<int64_t> stats_sum_{ 0 };                ///< 窗口统计：和
+    std::atomic<int64_t> stats_last_delta_{ 0 };         ///< 窗口统计：最近一次差值
+    std::atomic<int64_t> stats_latest_ns_{ 0 };          ///< 窗口统计：最新样本时间戳
+
+    // -------------------- 成员变量（仅写入方）--------------------
+    std::unique_ptr<uint64_t[]> min_queue_;  ///< 窗口最小值单调队列（样本序号环，值递增）
+    std::unique_ptr<uint64_t[]> max_queue_;  ///< 窗口最大值单调队列（样本序号环，值递减）
+    uint64_t min_front_ = 0;                 ///< 最小值队列队首（单调递增的计数，取模得槽位）
+    uint64_t min_back_ = 0;                  ///< 最小值队列队尾
+    uint64_t max_front_ = 0;                 ///< 最大值队列队首
+    uint64_t max_back_ = 0;                  ///< 最大值队列队尾
+    uint64_t window_begin_ = 0;              ///< 窗口内最旧样本序号
+    int64_t window_sum_ = 0;                 ///< 窗口内数值之和
+    int64_t running_total_ = 0;              ///< 已写入样本累计和
+};
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================
+// ValueTrace - 数值轨迹文件格式（只追加的二进制记录）
+// 文件头（24 字节）："DGLTRACE" + 版本(u32) + 保留(u32) + 录制开始的 Unix 毫秒时间(i64)
+// 之后为连续记录（小端序，首字节为记录类型）：
+//   - DEFINE：类型(u8) + 保留(u8) + 数值编号(u16) + ID 长度(u16) + ID 字节，首次出现某个数值 ID 时写入
+//   - SAMPLE：类型(u8) + 保留(u8) + 数值编号(u16) + 数值(i32) + 距首个样本的纳秒数(i64)，共 16 字节
+// 文件按块预先扩展并映射写入，类型为 END(0) 的字节表示结束（异常退出时未截断的预留区全为 0，读取同样在此停止）
+// ============================================
+namespace ValueTrace {
+
+constexpr char MAGIC[8] = { 'D', 'G', 'L', 'T', 'R', 'A', 'C', 'E' }; ///< 文件魔数
+constexpr uint32_t VERSION = 1;                                       ///< 格式版本
+constexpr size_t HEADER_BYTES = 24;                                   ///< 文件头字节数
+constexpr size_t DEFINE_HEADER_BYTES = 6;                             ///< DEFINE 记录固定部分字节数
+constexpr size_t SAMPLE_BYTES = 16;                                   ///< SAMPLE 记录字节数
+
+/// @brief 记录类型
+enum class RecordKind : uint8_t {
+    END = 0,    ///< 结束（或未写入的预留区）
+    DEFINE = 1, ///< 数值编号定义
+    SAMPLE = 2  ///< 数值样本
+};
+
+/// @brief 读取到的样本
+struct Sample {
+    int64_t timestamp_ns = 0; ///< 距首个样本的纳秒数
+    uint16_t value_index = 0; ///< 数值编号（经 ValueTraceReader::get_value_id 转为 ID）
+    int value = 0;            ///< 数值
+};
+
+} // namespace ValueTrace
+
+// ============================================
+// ValueTraceWriter - 数值轨迹录制
+// 文件按 GROW_BYTES 块扩展并以内存映射写入，追加一条记录只是一次内存拷贝；关闭时截断到实际长度
+// 非线程安全（ModuleManager 在持锁时写入）
+// ============================================
+class ValueTraceWriter {
+public:
+    // -------------------- 常量 --------------------
+    static constexpr qint64 GROW_BYTES = 4 << 20; ///< 每次扩展的文件字节数
+
+    // -------------------- 构造/析构 --------------------
+    ValueTraceWriter() = default;
+    ~ValueTraceWriter();
+    ValueTraceWriter(const ValueTraceWriter&) = delete;
+    ValueTraceWriter& operator=(const ValueTraceWriter&) = delete;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 创建（覆盖）轨迹文件并写入文件头（已打开时先关闭）
+    /// @param path 文件路径
+    /// @return 成功返回 true
+    bool open(const QString& path);
+
+    /// @brief 截断到实际长度并关闭文件
+    void close();
+
+    /// @brief 是否正在录制
+    /// @return 文件已打开返回 true
+    inline bool is_open() const { return map_ != nullptr; }
+
+    /// @brief 追加一个样本（首次出现的数值 ID 先写入 DEFINE 记录）
+    /// @param timestamp_ns 样本时刻（steady_clock 纳秒，首个样本作为零点）
+    /// @param value_id 数值 ID
+    /// @param value 数值
+    /// @return 成功返回 true，未打开、扩展失败或数值 ID 过多返回 false
+    bool append(int64_t timestamp_ns, const std::string& value_id, int value);
+
+    /// @brief 获取已写入的样本数
+    /// @return 样本数
+    inline uint64_t get_sample_count() const { return sample_count_; }
+
+private:
+    // -------------------- 私有辅助函数 --------------------
+    /// @brief 确保映射区剩余空间不少于 bytes，不足时扩展文件并重新映射
+    /// @param bytes 需要的字节数
+    /// @return 成功返回 true
+    bool reserve(qint64 bytes);
+    /// @brief 将数据拷贝到映射区末尾（调用前须 reserve）
+    /// @param data 数据
+    /// @param size 字节数
+    void write_bytes(const void* data, size_t size);
+
+    // -------------------- 成员变量 --------------------
+    QFile file_;                                    ///< 轨迹文件
+    uchar* map_ = nullptr;                          ///< 映射区起始地址
+    qint64 mapped_size_ = 0;                        ///< 映射区（文件）大小
+    qint64 length_ = 0;                             ///< 已写入字节数
+    int64_t base_ns_ = 0;                           ///< 首个样本时刻
+    uint64_t sample_count_ = 0;                     ///< 已写入样本数
+    std::unordered_map<std::string, uint16_t> ids_; ///< 数值 ID → 数值编号
+};
+
+// ============================================
+// ValueTraceReader - 数值轨迹读取
+// 只读映射整个文件，顺序解析记录（DEFINE 记录在读取过程中登记数值编号）
+// ============================================
+class ValueTraceReader {
+public:
+    // -------------------- 构造/析构 --------------------
+    ValueTraceReader() = default;
+    ~ValueTraceReader();
+    ValueTraceReader(const ValueTraceReader&) = delete;
+    ValueTraceReader& operator=(const ValueTraceReader&) = delete;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 打开并校验轨迹文件（已打开时先关闭）
+    /// @param path 文件路径
+    /// @return 成功返回 true，文件不存在或文件头不匹配返回 false
+    bool open(const QString& path);
+
+    /// @brief 关闭文件
+    void close();
+
+    /// @brief 读取下一个样本
+    /// @param out 输出样本
+    /// @return 读到样本返回 true，到达结尾或记录损坏返回 false
+    bool next(ValueTrace::Sample& out);
+
+    /// @brief 回到第一条记录
+    void rewind();
+
+    /// @brief 按数值编号获取数值 ID
+    /// @param value_index 数值编号
+    /// @return 数值 ID，未定义返回空字符串
+    const std::string& get_value_id(uint16_t value_index) const;
+
+    /// @brief 获取录制开始的 Unix 毫秒时间
+    /// @return 毫秒时间戳
+    inline int64_t get_start_unix_ms() const { return start_unix_ms_; }
+
+private:
+    // -------------------- 成员变量 --------------------
+    QFile file_;                      ///< 轨迹文件
+    const uchar* data_ = nullptr;     ///< 映射区起始地址
+    qint64 size_ = 0;                 ///< 文件大小
+    qint64 pos_ = 0;                  ///< 当前解析位置
+    int64_t start_unix_ms_ = 0;       ///< 录制开始的 Unix 毫秒时间
+    std::vector<std::string> ids_;    ///< 数值编号 → 数值 ID
+};
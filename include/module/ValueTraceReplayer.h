@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include "ValueTrace.h"
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================
+// ValueTraceReplayer - 数值轨迹回放
+// 按录制顺序把轨迹中的样本经 ModuleManager::push_values 写回（与 GSI 推送同一条路径，触发规则计算），
+// 同一时刻的样本合并为一批；可按录制节奏（可倍速）回放，也可不等待、尽快回放（分段让出事件循环）
+// 须与 ModuleManager 位于同一线程（推送在本线程内即时消费，规则计算与回放同步进行）
+// 样本以推送时刻打时间戳、不转为推送驱动；回放结束或停止时重置数值历史与变化判定状态
+// ============================================
+class ValueTraceReplayer : public QObject {
+    Q_OBJECT
+
+public:
+    // -------------------- 常量 --------------------
+    static constexpr int FAST_BATCHES_PER_TURN = 1024; ///< 尽快回放时每轮事件循环处理的批次数
+
+    // -------------------- 构造/析构 --------------------
+    explicit ValueTraceReplayer(QObject* parent = nullptr);
+    ~ValueTraceReplayer() override = default;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 开始回放（正在回放时先停止）
+    /// @param path 轨迹文件路径
+    /// @param speed 回放倍速（1 为按录制节奏，小于等于 0 表示不等待、尽快回放）
+    /// @return 成功打开轨迹返回 true
+    bool start(const QString& path, double speed = 1.0);
+
+    /// @brief 停止回放
+    void stop();
+
+    /// @brief 是否正在回放
+    /// @return 回放中返回 true
+    inline bool is_running() const { return running_; }
+
+signals:
+    /// @brief 回放结束（到达轨迹结尾）后发出
+    /// @param sample_count 回放的样本数
+    /// @param elapsed_ms 回放耗时（毫秒）
+    void finished(qint64 sample_count, qint64 elapsed_ms);
+
+private:
+    // -------------------- 私有辅助函数 --------------------
+    /// @brief 回放到期的样本，未到期时按下一个样本时刻重设定时器
+    void step();
+    /// @brief 读取下一个样本到 pending_
+    void read_next();
+
+    // -------------------- 成员变量 --------------------
+    ValueTraceReader reader_;                           ///< 轨迹读取
+    QTimer* timer_ = nullptr;                           ///< 回放定时器（单次触发）
+    double speed_ = 1.0;                                ///< 回放倍速（小于等于 0 表示尽快回放）
+    int64_t start_ns_ = 0;                              ///< 回放开始时刻（steady_clock 纳秒）
+    bool running_ = false;                              ///< 是否正在回放
+    qint64 sample_count_ = 0;                           ///< 已回放样本数
+    std::optional<ValueTrace::Sample> pending_;         ///< 下一个待回放样本
+    std::vector<std::pair<std::string, int>> batch_;    ///< 当前批次（复用缓冲）
+};
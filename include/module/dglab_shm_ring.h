@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * dglab_shm_ring.h - 共享内存数值环形缓冲（生产者端，纯 C 头文件，无需链接 DG-LAB-Client）
+ *
+ * DG-LAB-Client（ShmRingSource）启动时创建共享内存段并初始化环头，本地生产者（传感器、游戏插件等）
+ * 打开同名共享内存段后以 dglab_shm_ring_push 写入定长数值记录，客户端消费线程直接在共享内存中读取，
+ * 不经过套接字、不解析 JSON。单生产者单消费者：同一个共享内存段只允许一个生产者写入。
+ *
+ * 用法：
+ *     size_t bytes = 0;
+ *     dglab_shm_ring* ring = dglab_shm_ring_open("dglab_values", &bytes);   // 客户端未启动时返回 NULL
+ *     if (ring) {
+ *         dglab_shm_ring_push(ring, "health", 87);                        // 环满返回 0 并计入 dropped
+ *         dglab_shm_ring_close(ring, bytes);
+ *     }
+ *
+ * 内存布局（小端序）：dglab_shm_ring 环头（192 字节，生产者/消费者字段各占独立缓存行）
+ * 后接 capacity 个 dglab_shm_record（每个 32 字节）。head/tail 为单调递增的记录计数，槽位 = 计数 & (capacity - 1)。
+ */
+
+#ifndef DGLAB_SHM_RING_H
+#define DGLAB_SHM_RING_H
+
+/* 严格 C 标准模式下（如 -std=c99）启用 shm_open/mmap 声明；旧版 glibc 需链接 -lrt */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DGLAB_SHM_RING_MAGIC 0x474E5244u   /* "DRNG" */
+#define DGLAB_SHM_RING_VERSION 1u
+#define DGLAB_SHM_VALUE_ID_SIZE 24         /* 数值 ID 最长 23 字节，不足补 0 */
+
+/* 64 位计数与 32 位魔数的 acquire 读 / release 写（MSVC 下 x86/x64 的 volatile 访问即具有该语义） */
+#ifdef _MSC_VER
+#define DGLAB_SHM_LOAD_ACQUIRE(p) (*(volatile const uint64_t*)(p))
+#define DGLAB_SHM_STORE_RELEASE(p, v) (*(volatile uint64_t*)(p) = (v))
+#define DGLAB_SHM_LOAD_ACQUIRE32(p) (*(volatile const uint32_t*)(p))
+#define DGLAB_SHM_STORE_RELEASE32(p, v) (*(volatile uint32_t*)(p) = (v))
+#else
+#define DGLAB_SHM_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DGLAB_SHM_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define DGLAB_SHM_LOAD_ACQUIRE32(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DGLAB_SHM_STORE_RELEASE32(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+/* 单条数值记录 */
+typedef struct dglab_shm_record {
+    char value_id[DGLAB_SHM_VALUE_ID_SIZE]; /* 数值 ID（如 "health"），以 0 结尾 */
+    int32_t value;                          /* 数值 */
+    uint32_t reserved;                      /* 保留，写 0 */
+} dglab_shm_record;
+
+/* 环头（由客户端初始化） */
+typedef struct dglab_shm_ring {
+    uint32_t magic;       /* DGLAB_SHM_RING_MAGIC */
+    uint32_t version;     /* DGLAB_SHM_RING_VERSION */
+    uint32_t capacity;    /* 记录槽位数（2 的幂） */
+    uint32_t record_size; /* sizeof(dglab_shm_record) */
+    uint8_t pad0[48];
+    uint64_t head;        /* 生产者：已写入记录数 */
+    uint64_t dropped;     /* 生产者：环满丢弃的记录数 */
+    uint8_t pad1[48];
+    uint64_t tail;        /* 消费者：已读取记录数 */
+    uint8_t pad2[56];
+} dglab_shm_ring;
+
+/* 记录数组起始地址 */
+static inline dglab_shm_record* dglab_shm_ring_records(dglab_shm_ring* ring) {
+    return (dglab_shm_record*)((char*)ring + sizeof(dglab_shm_ring));
+}
+
+/* 容纳 capacity 条记录所需的共享内存字节数 */
+static inline size_t dglab_shm_ring_bytes(uint32_t capacity) {
+    return sizeof(dglab_shm_ring) + (size_t)capacity * sizeof(dglab_shm_record);
+}
+
+/* 平台共享内存名称：POSIX 为 "/<name>"，Windows 为 "Local\<name>" */
+static inline void dglab_shm_ring_native_name(const char* name, char* out, size_t out_size) {
+#ifdef _WIN32
+    snprintf(out, out_size, "Local\\%s", name);
+#else
+    snprintf(out, out_size, "/%s", name);
+#endif
+}
+
+/* 写入一条记录；成功返回 1，环满返回 0（记录被丢弃并计入 dropped） */
+static inline int dglab_shm_ring_push(dglab_shm_ring* ring, const char* value_id, int32_t value) {
+    uint64_t head = ring->head; /* 仅生产者写入，无需同步 */
+    uint64_t tail = DGLAB_SHM_LOAD_ACQUIRE(&ring->tail);
+    if (head - tail >= ring->capacity) {
+        DGLAB_SHM_STORE_RELEASE(&ring->dropped, ring->dropped + 1);
+        return 0;
+    }
+    dglab_shm_record* record = &dglab_shm_ring_records(ring)[head & (ring->capacity - 1)];
+    strncpy(record->value_id, value_id, DGLAB_SHM_VALUE_ID_SIZE - 1);
+    record->value_id[DGLAB_SHM_VALUE_ID_SIZE - 1] = '\0';
+    record->value = value;
+    record->reserved = 0;
+    DGLAB_SHM_STORE_RELEASE(&ring->head, head + 1);
+    return 1;
+}
+
+/* 打开客户端创建的共享内存段；失败（客户端未启动或版本不符）返回 NULL，成功时 *out_bytes 为映射字节数 */
+static inline dglab_shm_ring* dglab_shm_ring_open(const char* name, size_t* out_bytes) {
+    char native[256];
+    void* base = NULL;
+    size_t bytes = 0;
+    dglab_shm_ring_native_name(name, native, sizeof(native));
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, native);
+    MEMORY_BASIC_INFORMATION info;
+    if (mapping == NULL) {
+        return NULL;
+    }
+    base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    CloseHandle(mapping); /* 视图保持映射，句柄可关闭 */
+    if (base == NULL) {
+        return NULL;
+    }
+    VirtualQuery(base, &info, sizeof(info));
+    bytes = info.RegionSize;
+#else
+    struct stat st;
+    int fd = shm_open(native, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dglab_shm_ring)) {
+        close(fd);
+        return NULL;
+    }
+    bytes = (size_t)st.st_size;
+    base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+#endif
+    dglab_shm_ring* ring = (dglab_shm_ring*)base;
+    if (DGLAB_SHM_LOAD_ACQUIRE32(&ring->magic) != DGLAB_SHM_RING_MAGIC || ring->version != DGLAB_SHM_RING_VERSION
+        || ring->record_size != sizeof(dglab_shm_record) || bytes < dglab_shm_ring_bytes(ring->capacity)) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, bytes);
+#endif
+        return NULL;
+    }
+    if (out_bytes) {
+        *out_bytes = bytes;
+    }
+    return ring;
+}
+
+/* 解除映射（不删除共享内存段，段由客户端管理） */
+static inline void dglab_shm_ring_close(dglab_shm_ring* ring, size_t bytes) {
+#ifdef _WIN32
+    (void)bytes;
+    UnmapViewOfFile(ring);
+#else
+    munmap(ring, bytes);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DGLAB_SHM_RING_H */
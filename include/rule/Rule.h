@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "RuleExpression.h"
+
 #include <QJsonObject>
 
 #include <optional>
@@ -129,6 +131,9 @@ public:
     /// @brief 获取占位符数量
     size_t get_placeholder_count() const;
 
+    /// @brief 值模式是否已编译为原生字节码（否则求值时回退 QJSEngine）
+    inline bool is_value_pattern_native() const { return program_.is_native(); }
+
     // -------------------- 公共接口（计算）--------------------
     /// @brief 计算值: 将参数填入表达式并求值，根据模式钳位（旧式 {} 占位符）
     /// @param values 参数列表（数量必须匹配占位符）
@@ -154,6 +159,8 @@ public:
     std::string get_display_string() const;
 
 private:
+    friend class RuleEngineBench; ///< 基准测试（bench/RuleEngineBench.cpp）直接测量 parse_pattern
+
     // -------------------- 成员变量 --------------------
     std::string name_;                          ///< 规则名称
     std::string channel_;                       ///< 通道 "A"/"B"/""（兼容旧格式）
@@ -165,9 +172,10 @@ private:
     std::vector<Placeholder> placeholders_;     ///< 占位符列表
     std::vector<size_t> placeholder_positions_; ///< 各外部占位符位置（旧式 {}）
     size_t placeholder_count_ = 0;              ///< 占位符数量
+    RuleExpression program_;                    ///< 值模式编译结果（不支持的语法回退 QJSEngine）
 
     // -------------------- 私有辅助函数 --------------------
-    /// @brief 解析 value_pattern_ 中的占位符（{id:xxx}/{rule:xx}/{}），记录位置与类型
+    /// @brief 解析 value_pattern_ 中的占位符（{id:xxx}/{rule:xx}/{}），记录位置与类型，并编译为字节码
     void parse_pattern();
 
     /// @brief 将参数填入表达式，返回替换后的字符串（不计算）
@@ -175,8 +183,13 @@ private:
     /// @return 替换后的表达式，任一参数为空返回空字符串
     std::string evaluate_value_pattern(const std::vector<std::optional<int>>& values) const;
 
-    /// @brief 对原始表达式求值并钳位
+    /// @brief 对原始表达式求值并钳位（QJSEngine 回退路径）
     /// @param expr 已替换占位符的表达式
     /// @return 计算结果（已钳位）
     int evaluate_expression(const std::string& expr) const;
+
+    /// @brief 根据模式对结果进行范围钳位
+    /// @param raw_value 原始值
+    /// @return 钳位后的值
+    int clamp_by_mode(int raw_value) const;
 };
\ No newline at end of file
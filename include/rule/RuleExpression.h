@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// ============================================
+// 表达式字节码
+// ============================================
+enum class ExprOp : uint8_t {
+    PUSH_CONST = 0, ///< 压入常量
+    PUSH_SLOT = 1,  ///< 压入占位符槽位的值
+    ADD = 2,        ///< 加
+    SUB = 3,        ///< 减
+    MUL = 4,        ///< 乘
+    DIV = 5,        ///< 除（浮点除法，与 JS 语义一致）
+    MOD = 6,        ///< 取余（符号随被除数，与 JS 语义一致）
+    NEG = 7         ///< 取负
+};
+
+/// @brief 单条字节码指令
+struct ExprInstr {
+    ExprOp op = ExprOp::PUSH_CONST; ///< 操作码
+    uint32_t slot = 0;              ///< PUSH_SLOT 的槽位序号（与占位符顺序一致）
+    double value = 0.0;             ///< PUSH_CONST 的常量值
+};
+
+/// @brief 占位符在值模式原文中的区间（编译时替换为槽位）
+struct ExprSlotSpan {
+    size_t pos = 0; ///< 起始位置
+    size_t len = 0; ///< 长度（含花括号与名称注释）
+};
+
+// ============================================
+// RuleExpression - 值模式编译结果
+// 将值模式一次性编译为后缀字节码，热路径直接按槽位求值，不拼接字符串、不经过 JS 引擎
+// 支持: 整数/小数常量、占位符、+ - * / %、一元正负号、括号
+// ============================================
+class RuleExpression {
+public:
+    // -------------------- 构造/析构 --------------------
+    RuleExpression() = default;
+
+    // -------------------- 公共接口 --------------------
+    /// @brief 编译值模式
+    /// @param pattern 值模式原文
+    /// @param slots 占位符区间（按表达式顺序，序号即槽位）
+    /// @return 可原生求值返回 true；含不支持的语法时返回 false（调用方回退到 QJSEngine）
+    bool compile(const std::string& pattern, const std::vector<ExprSlotSpan>& slots);
+
+    /// @brief 是否已编译为可原生求值的字节码
+    inline bool is_native() const { return native_; }
+
+    /// @brief 获取字节码（只读，供调试/基准测试使用）
+    inline const std::vector<ExprInstr>& get_code() const { return code_; }
+
+    /// @brief 按槽位求值（按 JS ToInt32 语义转为整数，NaN/无穷大为 0）
+    /// @param values 槽位值（与占位符一一对应，调用方保证均有值）
+    /// @return 求值结果（未钳位）
+    /// @note 仅在 is_native() 为 true 时调用
+    int evaluate(const std::vector<std::optional<int>>& values) const;
+
+private:
+    // -------------------- 常量 --------------------
+    static constexpr size_t MAX_STACK_DEPTH = 64; ///< 求值栈最大深度（超出则回退 QJSEngine）
+
+    // -------------------- 成员变量 --------------------
+    std::vector<ExprInstr> code_; ///< 后缀字节码
+    bool native_ = false;         ///< 是否可原生求值
+};
@@ -5,28 +5,41 @@
 
 #pragma once
 
+#include "ModuleValueSlot.h"
+#include "MpscQueue.h"
 #include "Rule.h"
+#include "RuleTable.h"
 
 #include <nlohmann/json.hpp>
 
 #include <QJsonObject>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <queue>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 class ConfigManager;
 class AppConfig;
+class QThread;
 
 // ============================================
 // RuleManager - 规则管理器（单例）
 // 负责规则加载、启用判定、周期触发、规则间引用与级联计算
+// 模块数值变化经无锁队列投递到专用工作线程批量计算，结果事件按固定间隔合并后在 GUI 线程发出
+// 查询接口读取规则变化时发布的不可变快照（RCU），不加锁，不与级联计算竞争
 // ============================================
 class RuleManager : public QObject {
     Q_OBJECT
@@ -37,9 +50,12 @@ public:
     static RuleManager& instance();
 
     // -------------------- 初始化 --------------------
-    /// @brief 初始化规则目录和关键字（从 AppConfig 读取）
+    /// @brief 初始化规则目录和关键字（从 AppConfig 读取），并启动规则计算工作线程
     void init();
 
+    /// @brief 停止规则计算工作线程（等待当前波次完成，未处理的数值变化被丢弃）
+    void shutdown();
+
     // -------------------- 文件管理 --------------------
     /// @brief 获取所有可用的规则文件（不含默认的 rules.json）
     std::vector<std::string> get_available_rule_files() const;
@@ -70,7 +86,7 @@ public:
     /// @brief 重新加载规则（从当前配置管理器）
     void reload_rules();
 
-    // -------------------- 规则查询 --------------------
+    // -------------------- 规则查询（读取快照，不加锁）--------------------
     /// @brief 获取所有规则名称（按规则序号排序）
     /// @return 规则名称列表
     std::vector<std::string> get_rule_names() const;
@@ -150,7 +166,7 @@ public:
     /// @param channel 通道（"A"/"B"/空）
     void set_rule_channel(const std::string& rule_name, const std::string& channel);
 
-    /// @brief 设置规则的值模式表达式（重建规则对象并刷新引用索引）
+    /// @brief 设置规则的值模式表达式（重建规则对象，按差量更新引用索引，仅作废本规则及下游的缓存结果）
     /// @param rule_name 规则名称
     /// @param pattern 新的值模式表达式
     void set_rule_value_pattern(const std::string& rule_name, const std::string& pattern);
@@ -173,7 +189,7 @@ public:
     bool remove_rule_reference(const std::string& rule_name, int referenced_index);
 
     // -------------------- 通道启用状态 --------------------
-    /// @brief 设置通道启用状态（通道启用时触发直连规则计算）
+    /// @brief 设置通道启用状态（通道启用时投递工作线程计算直连规则）
     /// @param channel 通道（"A"/"B"）
     /// @param enabled 是否启用
     void set_channel_enabled(const std::string& channel, bool enabled);
@@ -184,15 +200,20 @@ public:
     bool get_channel_enabled(const std::string& channel) const;
 
     // -------------------- 计算 --------------------
-    /// @brief 计算指定规则（检查启用 → 解析占位符 → 求值 → 缓存 → 级联推送）
+    /// @brief 计算指定规则（检查启用 → 解析占位符 → 求值 → 缓存 → 按拓扑序级联推送）
+    /// @note 投递到工作线程执行，结果经 rule_command_ready/rule_result_changed 发出；工作线程未启动时同步执行
     /// @param rule_name 规则名称
-    /// @return 计算结果（可选），未启用或存在空值时返回空
-    std::optional<int> compute_rule(const std::string& rule_name);
+    void compute_rule(const std::string& rule_name);
+
+    /// @brief 按批次处理模块数值变化（一个批次为一个传播波次：每条受影响规则计算一次，每通道至多发送一条命令）
+    /// @param value_ids 本批次发生变化的数值 ID 列表
+    void process_value_changes(const std::vector<std::string>& value_ids);
 
-    /// @brief 手动计算规则并发送命令（供测试/手动触发使用）
+    /// @brief 手动计算规则并缓存结果（跳过启用检查，供测试/手动触发使用）
+    /// @note 投递到工作线程执行，结果可经 get_rule_last_result 查询；工作线程未启动时同步执行。
+    ///       未缓存结果的上游规则一并计算并缓存，但不级联下游、不发出 rule_command_ready/rule_result_changed
     /// @param rule_name 规则名称
-    /// @return 计算结果（可选）
-    std::optional<int> trigger_rule(const std::string& rule_name);
+    void trigger_rule(const std::string& rule_name);
 
     // -------------------- 模板方法（命令生成）--------------------
     /// @brief 根据规则名称和参数生成命令（旧式 {} 占位符传参）
@@ -215,21 +236,25 @@ signals:
     /// @brief 规则集发生变化时发出（用于刷新界面）
     void rules_changed();
 
-    /// @brief 规则计算完成且父级为通道时发出（用于首页通道规则卡片刷新）
+    /// @brief 规则计算完成且父级为通道时发出（用于首页通道规则卡片刷新，按 UI_FLUSH_INTERVAL_MS 合并，同一规则只保留最新值）
     /// @param rule_name 规则名称
     /// @param channel 通道（"A"/"B"）
     /// @param value 计算结果
     void rule_result_changed(const QString& rule_name, const QString& channel, int value);
 
 private:
+    friend class RuleEngineBench; ///< 基准测试（bench/RuleEngineBench.cpp）直接调用 parse_config
+
     // -------------------- 构造/析构（单例私有）--------------------
     RuleManager();
     ~RuleManager() override;
 
+    // -------------------- 常量 --------------------
+    static constexpr int UI_FLUSH_INTERVAL_MS = 50;    ///< 结果事件合并发送间隔（毫秒）
+
     // -------------------- 成员变量 --------------------
-    std::map<int, std::string> index_to_name_;         ///< 规则序号 → 名称（有序）
-    std::unordered_map<std::string, Rule> rules_;      ///< 规则映射
-    mutable std::mutex mutex_;                         ///< 保护规则映射
+    RuleTable table_;                                  ///< 规则表（按规则序号寻址的列式存储）
+    mutable std::mutex mutex_;                         ///< 保护规则表
     std::shared_ptr<ConfigManager> config_manager_;    ///< 配置管理器（用于从配置加载）
     std::string rules_dir_;                            ///< 规则目录
     std::string keyword_;                              ///< 规则文件关键字
@@ -239,38 +264,87 @@ private:
     /// @brief 规则结果事件（规则名、通道、计算结果）
     using ResultEvent = std::tuple<std::string, std::string, int>;
 
-    std::map<int, std::vector<int>> referrers_;        ///< 规则序号 → 引用它的规则序号列表（{rule:xx}）
-    std::map<std::string, std::vector<int>> id_users_; ///< 数值 ID → 引用它的规则序号列表（{id:xxx}）
-    std::map<int, std::optional<int>> last_results_;   ///< 规则序号 → 最近计算结果
-    std::map<std::string, bool> channel_enabled_;      ///< 通道启用状态（A/B）
-    int compute_depth_ = 0;                            ///< 级联计算深度（防循环引用）
-    static constexpr int MAX_COMPUTE_DEPTH = 16;       ///< 最大级联深度
+    std::unordered_map<std::string, std::vector<int>> id_users_; ///< 数值 ID → 引用它的规则序号列表（{id:xxx}）
+    uint8_t channel_enabled_mask_ = 0;                 ///< 通道启用位掩码（RuleTable::CHANNEL_A/CHANNEL_B）
+    std::vector<int> topo_order_;                      ///< 规则序号的拓扑序（被引用者在前）
+    std::vector<int> topo_rank_;                       ///< 规则序号 → 拓扑序位置（-1 表示不存在）
+    std::vector<bool> cyclic_;                         ///< 规则序号 → 是否处于循环引用中（不参与计算）
+    std::vector<bool> effective_;                      ///< 规则序号 → 有效启用位（缓存，仅在启用/通道/引用关系变化时更新）
+    std::vector<uint32_t> region_stamp_;               ///< 规则序号 → 最近一次所属的重算区域编号（避免每次清零）
+    uint32_t region_epoch_ = 0;                        ///< 当前重算区域编号
+
+    QThread* worker_thread_ = nullptr;                 ///< 规则计算工作线程
+    QObject* worker_ = nullptr;                        ///< 工作线程上下文对象（排队调用的目标）
+    MpscQueue<std::vector<std::string>> input_queue_;  ///< 待处理的数值变化批次（多生产者，工作线程消费）
+    std::atomic<bool> drain_scheduled_{ false };       ///< 工作线程是否已排队一次队列消费
+    std::mutex ui_mutex_;                              ///< 保护待发送的结果事件
+    std::map<std::pair<std::string, std::string>, int> pending_ui_results_; ///< (规则名, 通道) → 最新结果
+    std::atomic<bool> ui_flush_scheduled_{ false };    ///< GUI 线程是否已安排一次结果发送
+
+    /// @brief 规则集只读快照（规则变化时整体发布，发布后不再修改；最近结果为与引擎共享的原子槽位）
+    struct RuleSnapshot {
+        uint64_t version = 0;                          ///< 快照版本号（每次发布递增）
+        RuleTable table;                               ///< 规则表副本（与引擎按列写时复制共享，last_result 列不使用）
+        std::vector<bool> effective;                   ///< 规则序号 → 有效启用位
+        uint8_t channel_enabled_mask = 0;              ///< 通道启用位掩码
+        std::shared_ptr<const std::vector<ModuleValueSlot>> results; ///< 规则序号 → 最近结果（随计算实时更新）
+    };
+
+    std::shared_ptr<const RuleSnapshot> snapshot_;     ///< 当前发布的快照（仅经 load_snapshot/publish_snapshot_locked 原子读写）
+    std::shared_ptr<std::vector<ModuleValueSlot>> result_slots_; ///< 规则序号 → 最近结果原子槽位（引擎写入，快照共享）
+    uint64_t snapshot_version_ = 0;                    ///< 最近发布的快照版本号
+
+    /// @brief 一次传播波次的状态（脏规则按拓扑序出队，每条规则每波至多计算一次）
+    struct PropagationWave {
+        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
+            std::greater<>> dirty;                     ///< (拓扑序, 规则序号) 小顶堆
+        std::vector<uint8_t> state;                    ///< 规则序号 → 0=未标记 1=已入队 2=已计算
+        std::vector<std::optional<int>> computed;      ///< 规则序号 → 本波次计算结果
+        std::array<std::optional<QJsonObject>, 2> channel_commands; ///< 每通道至多一条待发送命令（A/B，后计算者覆盖）
+        std::vector<ResultEvent> pending_results;      ///< 待发送的结果事件
+    };
 
     // -------------------- 私有辅助函数 --------------------
     void scan_directory();                                                                 ///< 扫描目录获取可用文件
     std::string get_full_path(const std::string& filename) const;                          ///< 获取完整路径
     bool save_json_file(const std::string& filename, const nlohmann::json& content) const; ///< 保存 JSON 文件
-    void parse_config(const nlohmann::json& config);                                       ///< 解析规则配置
-    void rebuild_indexes();                                                                ///< 重建序号映射与引用索引
+    std::vector<std::string> parse_config(const nlohmann::json& config);                   ///< 解析规则配置，返回需恢复查询周期的数值 ID（见 restore_value_periods）
+    void rebuild_indexes();                                                                ///< 重建序号映射、引用索引与拓扑序（有效启用位由调用方刷新）
+    void rebuild_topology();                                                               ///< 强连通分量检测并生成拓扑序（迭代 Tarjan）
+    void bind_value_slots_locked();                                                        ///< 预绑定 {id:xxx} 占位符的数值槽位（需已持有锁）
+    std::pair<size_t, size_t> bind_rule_value_slots_locked(int rule_index);                ///< 预绑定单条规则的数值槽位，返回 (已绑定, 未绑定) 数量（需已持有锁）
+    std::vector<std::string> update_rule_pattern_locked(int rule_index, const std::string& pattern); ///< 替换值模式并按差量维护引用索引、拓扑序与缓存结果，返回需恢复查询周期的数值 ID（需已持有锁）
     void deduplicate_channel_parents();                                                    ///< 通道父级唯一性去重（加载时）
     void deduplicate_channel_parents_keep(const std::string& keep_name,
         const std::string& channel);                                                       ///< 通道父级唯一性去重（手动设置时保留指定规则）
-    bool is_rule_effectively_enabled_locked(const std::string& rule_name,
-        std::vector<std::string>& visiting) const;                                         ///< 有效启用判定（需已持有锁）
-    std::optional<int> compute_rule_locked(const std::string& rule_name,
-        std::vector<QJsonObject>& pending_commands,
-        std::vector<ResultEvent>& pending_results);                                        ///< 计算规则（需已持有锁，收集待发送命令与结果事件）
+    bool is_rule_effectively_enabled_locked(int rule_index) const;                         ///< 有效启用判定（读取缓存位，需已持有锁）
+    std::vector<std::string> refresh_effective_locked();                                   ///< 全量重算有效启用位，返回新启用规则引用的数值 ID（需已持有锁）
+    std::vector<std::string> refresh_effective_locked(const std::vector<int>& seeds);      ///< 增量重算种子规则及其上游的有效启用位，返回新启用规则引用的数值 ID（需已持有锁）
+    void restore_value_periods(const std::vector<std::string>& value_ids) const;           ///< 被退避的数值恢复最快查询周期（须在释放 mutex_ 后调用，避免持锁进入 ModuleManager）
+    void mark_dirty_locked(int rule_index, PropagationWave& wave) const;                   ///< 标记脏规则（连带未缓存结果的上游规则，需已持有锁）
+    void drain_wave_locked(PropagationWave& wave);                                         ///< 按拓扑序计算波次内所有脏规则（需已持有锁）
+    std::optional<int> evaluate_rule_locked(int rule_index, PropagationWave& wave);        ///< 计算单条规则并标记下游（需已持有锁）
+    std::optional<int> compute_values_locked(int rule_index) const;                        ///< 解析占位符并求值（需已持有锁）
+    void set_last_result_locked(int rule_index, std::optional<int> value);                ///< 缓存最近结果（同步写入快照共享的结果槽位，需已持有锁）
+    void publish_snapshot_locked();                                                        ///< 发布规则集快照（需已持有锁）
+    std::shared_ptr<const RuleSnapshot> load_snapshot() const;                             ///< 原子读取当前快照（不加锁）
     std::optional<int> resolve_placeholder_locked(const Placeholder& placeholder,
-        std::vector<QJsonObject>& pending_commands,
-        std::vector<ResultEvent>& pending_results);                                        ///< 解析单个占位符（需已持有锁）
+        const ModuleValueSlot* slot) const;                                                ///< 解析单个占位符（需已持有锁）
+    void emit_wave(const PropagationWave& wave);                                           ///< 发送波次收集的命令与结果事件（解锁后调用）
+    void drain_input_queue();                                                              ///< 合并队列中所有批次并计算（工作线程）
+    void post_to_worker(std::function<void()> task);                                       ///< 投递计算任务到工作线程（未启动时同步执行）
+    void compute_rule_now(const std::string& rule_name);                                   ///< 计算指定规则并级联（工作线程）
+    void trigger_rule_now(const std::string& rule_name);                                   ///< 手动计算规则（工作线程）
+    void compute_channel_rules(uint8_t bit);                                               ///< 计算直连指定通道的规则并级联（工作线程）
+    void flush_ui_results();                                                               ///< 发送合并后的结果事件（GUI 线程）
 
 private slots:
-    /// @brief 模块数值变化时触发值模式中引用该数值的规则计算
-    /// @param module_name 模块名称
-    /// @param value_id 数值 ID
-    /// @param new_value 最新数值
-    void on_module_value_changed(const QString& module_name, const QString& value_id,
-        int new_value);
+    /// @brief 模块数值批量变化时投递到工作线程，触发值模式中引用这些数值的规则计算（积压的批次合并为一个传播波次）
+    /// @param value_ids 本批次发生变化的数值 ID 列表
+    void on_module_values_changed(const QStringList& value_ids);
+
+    /// @brief 模块数值注册完成时重新绑定 {id:xxx} 占位符的数值槽位
+    void on_module_values_registered();
 };
 
 #include "RuleManager_impl.hpp"
\ No newline at end of file
@@ -17,10 +17,10 @@
 template<typename... Args>
 inline QJsonObject RuleManager::evaluate_command(const std::string& rule_name, Args... args) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    int index = table_.find(rule_name);
+    if (index < 0) {
         throw std::runtime_error("规则不存在: " + rule_name);
     }
     std::vector<int> values = {args...};
-    return it->second.generate_command(values);
+    return table_.rule(index).generate_command(values);
 }
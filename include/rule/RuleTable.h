@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#pragma once
+
+#include "ModuleValueSlot.h"
+#include "Rule.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ============================================
+// RuleTable - 规则表（按规则序号寻址的列式存储）
+// 规则序号 1..N 稠密连续，第 i 条规则的各列数据位于各数组的 i-1 处
+// 热路径（启用、模式、通道父级、引用者、最近结果、数值槽位）为独立的连续数组，名称仅用于 UI 接口查找
+// 各列写时复制：复制规则表只共享各列（规则对象按行共享且不可变），之后修改哪一列才复制哪一列
+// ============================================
+class RuleTable {
+public:
+    // -------------------- 通道位 --------------------
+    static constexpr uint8_t CHANNEL_A = 0x01; ///< 通道 A 位
+    static constexpr uint8_t CHANNEL_B = 0x02; ///< 通道 B 位
+
+    // -------------------- 构造/析构 --------------------
+    RuleTable() = default;
+
+    // -------------------- 容量与查找 --------------------
+    /// @brief 清空所有规则
+    void clear();
+
+    /// @brief 预留容量
+    /// @param count 规则数量
+    void reserve(size_t count);
+
+    /// @brief 追加规则（规则序号必须为 size() + 1）
+    /// @param rule 规则对象
+    /// @return 规则序号，名称重复或序号不连续返回 -1
+    int add(Rule rule);
+
+    /// @brief 规则数量
+    inline size_t size() const { return rules_.get().size(); }
+
+    /// @brief 判断规则序号是否有效
+    /// @param rule_index 规则序号
+    inline bool contains(int rule_index) const {
+        return rule_index > 0 && static_cast<size_t>(rule_index) <= rules_.get().size();
+    }
+
+    /// @brief 按名称查找规则序号
+    /// @param name 规则名称
+    /// @return 规则序号，不存在返回 -1
+    int find(const std::string& name) const;
+
+    // -------------------- 冷数据（规则对象）--------------------
+    /// @brief 获取规则对象（名称、值模式、占位符、编译结果等）
+    inline const Rule& rule(int rule_index) const { return *rules_.get()[rule_index - 1]; }
+
+    /// @brief 获取规则名称
+    inline const std::string& name(int rule_index) const { return rule(rule_index).get_name(); }
+
+    // -------------------- 热数据列 --------------------
+    inline bool enabled(int rule_index) const { return enabled_.get()[rule_index - 1] != 0; }
+    inline int mode(int rule_index) const { return modes_.get()[rule_index - 1]; }
+    inline uint8_t channel_mask(int rule_index) const { return channel_masks_.get()[rule_index - 1]; }
+    inline const std::vector<int>& referrers(int rule_index) const { return referrers_.get()[rule_index - 1]; }
+    inline const std::vector<int>& dependencies(int rule_index) const {
+        return dependencies_.get()[rule_index - 1];
+    }
+    inline const std::optional<int>& last_result(int rule_index) const {
+        return last_results_.get()[rule_index - 1];
+    }
+
+    /// @brief 获取直连指定通道的规则序号列表（升序，随通道父级变化维护）
+    /// @param bit 通道位（CHANNEL_A/CHANNEL_B）
+    inline const std::vector<int>& channel_rules(uint8_t bit) const {
+        return channel_rules_.get()[bit == CHANNEL_B ? 1 : 0];
+    }
+
+    /// @brief 获取预绑定的数值槽位（与占位符一一对应，非 {id:xxx} 或未找到的数值为空）
+    inline const std::vector<std::shared_ptr<const ModuleValueSlot>>& value_slots(int rule_index) const {
+        return value_slots_.get()[rule_index - 1];
+    }
+
+    // -------------------- 修改 --------------------
+    /// @brief 设置启用状态（同步规则对象与启用列）
+    void set_enabled(int rule_index, bool enabled);
+
+    /// @brief 设置父级列表（同步规则对象与通道位列）
+    void set_parents(int rule_index, const std::vector<RuleParent>& parents);
+
+    /// @brief 替换规则对象（序号与名称保持不变，同步各列）
+    void replace(int rule_index, Rule rule);
+
+    /// @brief 设置最近一次计算结果
+    inline void set_last_result(int rule_index, std::optional<int> value) {
+        last_results_.mut()[rule_index - 1] = value;
+    }
+
+    /// @brief 清空所有最近结果
+    void clear_last_results();
+
+    /// @brief 清空所有引用关系（引用者与依赖列表）
+    void clear_referrers();
+
+    /// @brief 记录引用关系（referrer 的值模式引用了 rule_index）
+    inline void add_referrer(int rule_index, int referrer) {
+        referrers_.mut()[rule_index - 1].push_back(referrer);
+        dependencies_.mut()[referrer - 1].push_back(rule_index);
+    }
+
+    /// @brief 对所有引用关系排序去重（保证级联触发顺序稳定）
+    void sort_referrers();
+
+    /// @brief 有序插入一条引用关系（增量维护，已存在则忽略）
+    /// @param rule_index 被引用的规则序号
+    /// @param referrer 引用者规则序号
+    void insert_referrer(int rule_index, int referrer);
+
+    /// @brief 移除一条引用关系（增量维护，不存在则忽略）
+    /// @param rule_index 被引用的规则序号
+    /// @param referrer 引用者规则序号
+    void erase_referrer(int rule_index, int referrer);
+
+    /// @brief 设置预绑定的数值槽位
+    inline void set_value_slots(int rule_index,
+        std::vector<std::shared_ptr<const ModuleValueSlot>> bound_slots) {
+        value_slots_.mut()[rule_index - 1] = std::move(bound_slots);
+    }
+
+    // -------------------- 静态工具 --------------------
+    /// @brief 通道名转通道位（"A"/"B"，其他返回 0）
+    static uint8_t channel_bit(const std::string& channel);
+
+    /// @brief 由父级列表计算通道位掩码
+    static uint8_t channel_mask_of(const std::vector<RuleParent>& parents);
+
+private:
+    // -------------------- 写时复制列 --------------------
+    /// @brief 写时复制列（规则表副本共享同一数组，写入前若仍被共享则先复制）
+    /// @note 仅持有规则表的一方（持 RuleManager::mutex_）写入，副本只读
+    template<typename T>
+    class Column {
+    public:
+        Column() : data_(std::make_shared<T>()) {}
+
+        /// @brief 只读访问
+        inline const T& get() const { return *data_; }
+
+        /// @brief 可写访问（被副本共享时先复制本列）
+        inline T& mut() {
+            if (data_.use_count() > 1) {
+                data_ = std::make_shared<T>(*data_);
+            }
+            return *data_;
+        }
+
+        /// @brief 替换为空列（不复制旧数据）
+        inline void reset() { data_ = std::make_shared<T>(); }
+
+    private:
+        std::shared_ptr<T> data_; ///< 列数据
+    };
+
+    // -------------------- 私有辅助函数 --------------------
+    void update_channel_mask(int rule_index, uint8_t mask);  ///< 写入通道位列并同步通道成员列表
+
+    // -------------------- 成员变量 --------------------
+    Column<std::vector<std::shared_ptr<const Rule>>> rules_;   ///< 规则对象（冷数据，按行共享，修改时替换整行）
+    Column<std::vector<uint8_t>> enabled_;                      ///< 启用状态
+    Column<std::vector<int>> modes_;                            ///< 模式 0-4
+    Column<std::vector<uint8_t>> channel_masks_;                ///< 通道父级位掩码（CHANNEL_A/CHANNEL_B）
+    Column<std::array<std::vector<int>, 2>> channel_rules_;     ///< 通道 → 直连该通道的规则序号（A/B，升序）
+    Column<std::vector<std::vector<int>>> referrers_;           ///< 引用该规则的规则序号列表（{rule:xx}）
+    Column<std::vector<std::vector<int>>> dependencies_;        ///< 该规则引用的规则序号列表（referrers_ 的反向）
+    Column<std::vector<std::optional<int>>> last_results_;      ///< 最近计算结果
+    Column<std::vector<std::vector<std::shared_ptr<const ModuleValueSlot>>>> value_slots_; ///< 预绑定的数值槽位（按占位符顺序）
+    Column<std::unordered_map<std::string, int>> name_to_index_; ///< 名称 → 规则序号
+};
@@ -9,10 +9,12 @@
 #include "LogExporter.h"
 #include "PythonSubprocessManager.h"
 #include "ThemeSelectorDialog.h"
+#include "ValueTraceReplayer.h"
 #include "ui_DGLABClient.h"
 
 #include <QCloseEvent>
 #include <QComboBox>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QMenu>
 #include <QPushButton>
@@ -137,6 +139,10 @@ private:
     static constexpr int CHANNEL_CARD_TITLE_SPACING = 6;   ///< 标题与信息列表间距
     static constexpr int CHANNEL_CARD_WIDTH_STRETCH = 1;   ///< 模块/规则/波形卡片宽度比例（1:1:1）
 
+    // -------------------- 常量（规则命令批量发送）--------------------
+    static constexpr int RULE_BATCH_MAX_OPS = 32;         ///< 单个 batch 命令最多携带的规则命令数
+    static constexpr int RULE_COMMAND_TIMEOUT_MS = 5000;  ///< 规则命令（含 batch）响应超时（毫秒）
+
     // -------------------- 成员变量 --------------------
     Ui::DGLABClientClass ui_;                       ///< UI 界面
     QSyntaxHighlighter* log_highlighter_ = nullptr; ///< 日志高亮器
@@ -159,6 +165,7 @@ private:
 
     PythonSubprocessManager* py_manager_; ///< Python 子进程管理器
     LogExporter log_exporter_;             ///< 日志导出器（导出设置与导出/清理逻辑）
+    ValueTraceReplayer* trace_replayer_ = nullptr; ///< 数值轨迹回放（配置了 app.trace.replay_path 时创建）
 
     LogLevel ui_log_level_ = LOG_DEBUG; ///< UI 日志级别
     bool use_fixed_width_log_ = false;  ///< 是否使用固定宽度日志格式
@@ -184,6 +191,10 @@ private:
     ModuleValuesDialog* module_values_dialog_ = nullptr; ///< 模块数值弹窗（防重复打开）
     std::map<std::string, QLabel*> rule_value_labels_;    ///< "通道:规则名" → 数值标签（首页规则卡片）
 
+    // 规则命令批量发送
+    QJsonArray pending_rule_commands_;  ///< 本轮事件循环中就绪、尚未发送的规则命令（按就绪顺序）
+    bool rule_flush_scheduled_ = false; ///< 是否已安排在本轮事件循环末尾发送
+
     // -------------------- 私有辅助函数（初始化） --------------------
     /// @brief 配置日志控件为只读并设置默认字体
     void setup_debug_log();
@@ -219,6 +230,8 @@ private:
     void setup_module_ui();
     /// @brief 连接规则引擎信号（规则命令发送到 Python 端）
     void connect_rule_engine();
+    /// @brief 发送本轮事件循环中积累的规则命令（单条直接发送，多条合并为 batch 命令）
+    void flush_rule_commands();
     /// @brief 填充首页 A/B 通道卡片（模块区域 + 规则区域）
     void setup_channel_cards();
     /// @brief 填充单个通道的模块卡片（模块名称 + 最小查询周期）
@@ -10,7 +10,6 @@
 
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QThreadPool>
 
 #include <string>
 
@@ -20,24 +19,22 @@
 
 template<typename Callback>
 inline void DGLABClient::async_call(const QJsonObject& cmd, int timeout, Callback&& callback) {
-    LOG_MODULE("DGLABClient", "async_call", LOG_DEBUG, "在后台线程执行异步调用");
-    QThreadPool::globalInstance()->start([this, cmd, timeout, callback = std::forward<Callback>(callback)]() mutable {
-        try {
-            std::string msg = "正在发送命令: " + DebugLogUtil::remove_newline(QJsonDocument(cmd).toJson().toStdString());
-            LOG_MODULE("DGLABClient", "async_call", LOG_DEBUG, msg);
-            py_manager_->call(cmd, [callback = std::move(callback)](const QJsonObject& resp) mutable {
-                bool ok = resp["status"].toString() == "ok";
-                QString msg = resp["message"].toString();
-                callback(ok, msg); }, timeout);
-        }
-        catch (const std::runtime_error& e) {
-            emit close_finished(false, QString("运行时错误: ") + e.what());
-        }
-        catch (const std::exception& e) {
-            emit close_finished(false, QString("异常: ") + e.what());
-        }
-        catch (...) {
-            emit close_finished(false, "未知异常");
-        }
-    });
+    // call 本身非阻塞（写出后立即返回，响应到达时在主线程回调），无需放入线程池
+    try {
+        LOG_MODULE("DGLABClient", "async_call", LOG_DEBUG,
+            "正在发送命令: " << DebugLogUtil::remove_newline(QJsonDocument(cmd).toJson().toStdString()));
+        py_manager_->call(cmd, [callback = std::forward<Callback>(callback)](const QJsonObject& resp) mutable {
+            bool ok = resp["status"].toString() == "ok";
+            QString msg = resp["message"].toString();
+            callback(ok, msg); }, timeout);
+    }
+    catch (const std::runtime_error& e) {
+        emit close_finished(false, QString("运行时错误: ") + e.what());
+    }
+    catch (const std::exception& e) {
+        emit close_finished(false, QString("异常: ") + e.what());
+    }
+    catch (...) {
+        emit close_finished(false, "未知异常");
+    }
 }
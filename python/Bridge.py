@@ -5,6 +5,9 @@
 
 from WebSocketCore import DGLabClient
 
+import CborCodec
+
+import argparse
 import asyncio
 import json
 import logging
@@ -21,10 +24,16 @@ class DGLabServer:
     负责接收Qt客户端（或其他TCP客户端）的JSON命令，转换为DGLab WebSocket协议并转发。
     """
 
+    # 支持的消息格式（按优先级），由 hello 命令协商:
+    #   "json": 每条消息一行 JSON（默认，协商前及对端不支持 CBOR 时使用）
+    #   "cbor": 4 字节大端长度 + CBOR 负载（见 CborCodec.py）
+    SUPPORTED_FORMATS = ("cbor", "json")
+
     def __init__(self):
         self.dglab = DGLabClient()
         self.server = None
         self.qt_client = None
+        self.frame_format = "json"  # 当前连接使用的消息格式
         self.dglab.set_on_message(self._on_ws_message)
 
     @staticmethod
@@ -60,27 +69,46 @@ class DGLabServer:
 
     async def handle_qt_client(self, reader, writer):
         """
-        处理单个 TCP 客户端连接，循环读取 JSON 命令并响应。
+        处理单个客户端连接（TCP 或本地套接字），循环读取命令并响应。
         """
         self.qt_client = writer
+        self.frame_format = "json"  # 新连接从 JSON 开始，hello 协商后切换
         addr = writer.get_extra_info('peername')
         logger.info(f"[DGLabServer] <handle_qt_client> (LOG_INFO): Qt客户端已连接: {addr}")
 
         try:
             while True:
-                # 读取一行（以换行符分隔）
-                data = await reader.readline()
-                if not data:
-                    break  # 客户端关闭连接
-
-                # 解析 JSON
-                try:
-                    cmd = json.loads(data.decode())
+                if self.frame_format == "cbor":
+                    # 读取一帧（长度前缀 + CBOR）
+                    try:
+                        cmd = await CborCodec.read_frame(reader)
+                    except CborCodec.CborFrameError:
+                        raise
+                    except CborCodec.CborDecodeError as e:
+                        logger.warning(f"[DGLabServer] <handle_qt_client> (LOG_WARN): 收到无效 CBOR 帧: {e}")
+                        await self.send_response(writer, {"status": "error", "message": "Invalid CBOR"})
+                        continue
+                    if cmd is None:
+                        break  # 客户端关闭连接
+                    if not isinstance(cmd, dict):
+                        logger.warning("[DGLabServer] <handle_qt_client> (LOG_WARN): CBOR 帧不是对象，忽略")
+                        await self.send_response(writer, {"status": "error", "message": "Invalid CBOR"})
+                        continue
                     logger.debug(f"[DGLabServer] <handle_qt_client> (LOG_DEBUG): 收到命令: {cmd}")
-                except json.JSONDecodeError:
-                    logger.warning("[DGLabServer] <handle_qt_client> (LOG_WARN): 收到无效 JSON，忽略")
-                    await self.send_response(writer, {"status": "error", "message": "Invalid JSON"})
-                    continue
+                else:
+                    # 读取一行（以换行符分隔）
+                    data = await reader.readline()
+                    if not data:
+                        break  # 客户端关闭连接
+
+                    # 解析 JSON
+                    try:
+                        cmd = json.loads(data.decode())
+                        logger.debug(f"[DGLabServer] <handle_qt_client> (LOG_DEBUG): 收到命令: {cmd}")
+                    except json.JSONDecodeError:
+                        logger.warning("[DGLabServer] <handle_qt_client> (LOG_WARN): 收到无效 JSON，忽略")
+                        await self.send_response(writer, {"status": "error", "message": "Invalid JSON"})
+                        continue
 
                 # 处理命令
                 try:
@@ -91,8 +119,14 @@ class DGLabServer:
                     if "req_id" in cmd:
                         response["req_id"] = cmd["req_id"]
 
-                # 发送响应
-                await self.send_response(writer, response)
+                # 发送响应（hello 的响应仍按协商前的格式发送，之后双方切换到协商的格式）
+                switch_to = None
+                if cmd.get("cmd") == "hello" and response.get("status") == "ok":
+                    switch_to = response["format"]
+                await self.send_response(writer, response, switch_to)
+
+        except CborCodec.CborFrameError as e:
+            logger.error(f"[DGLabServer] <handle_qt_client> (LOG_ERROR): 帧流损坏，断开连接: {e}")
 
         except asyncio.CancelledError:
             logger.debug("[DGLabServer] <handle_qt_client> (LOG_DEBUG): TCP 客户端处理任务被取消")
@@ -102,10 +136,20 @@ class DGLabServer:
             await writer.wait_closed()
             logger.info("[DGLabServer] <handle_qt_client> (LOG_INFO): Qt客户端已断开")
 
-    async def send_response(self, writer, response):
-        """发送 JSON 响应，每条消息以换行符结尾，便于 TCP 流解析。"""
-        data = json.dumps(response).encode() + b'\n'
+    async def send_response(self, writer, response, switch_to=None):
+        """
+        按当前协商的格式发送响应: JSON 每条消息以换行符结尾，CBOR 为长度前缀帧。
+        switch_to 非空时，本条响应按旧格式编码，写入后立即切换格式（编码、写入与切换之间无 await，
+        并发发送的主动消息不会夹在中间以错误的格式发出）。
+        """
+        if self.frame_format == "cbor":
+            data = CborCodec.encode_frame(response)
+        else:
+            data = json.dumps(response).encode() + b'\n'
         writer.write(data)
+        if switch_to is not None:
+            self.frame_format = switch_to
+            logger.info(f"[DGLabServer] <send_response> (LOG_INFO): 消息格式已切换为 {switch_to}")
         await writer.drain()
         logger.debug(f"[DGLabServer] <send_response> (LOG_DEBUG): 响应已发送: {response}")
 
@@ -128,8 +172,42 @@ class DGLabServer:
         cmd_type = cmd.get("cmd")
         logger.debug(f"[DGLabServer] <process_command> (LOG_DEBUG): 处理命令: {cmd_type}, req_id={req_id}")
 
+        # ---------- 消息格式协商 ----------
+        if cmd_type == "hello":
+            offered = cmd.get("formats", [])
+            chosen = next((f for f in self.SUPPORTED_FORMATS if f in offered), "json")
+            logger.info(f"[DGLabServer] <process_command> (LOG_INFO): 协商消息格式: 对端支持 {offered}，选用 {chosen}")
+            response = {"status": "ok", "message": chosen, "format": chosen}
+
+        # ---------- 批量命令 ----------
+        elif cmd_type == "batch":
+            ops = cmd.get("ops")
+            if not isinstance(ops, list) or not ops:
+                logger.warning("[DGLabServer] <process_command> (LOG_WARN): batch 缺少 ops 参数或 ops 不是非空数组")
+                response = {"status": "error", "message": "ops 必须为非空命令数组"}
+            else:
+                # 按顺序逐条执行，一条失败不影响后续命令
+                results = []
+                for index, op in enumerate(ops):
+                    if not isinstance(op, dict) or op.get("cmd") in ("batch", "hello"):
+                        logger.warning(f"[DGLabServer] <process_command> (LOG_WARN): batch 第 {index} 条命令无效: {op}")
+                        results.append({"status": "error", "message": "无效的批量子命令"})
+                        continue
+                    try:
+                        results.append(await self.process_command(op))
+                    except Exception as e:
+                        logger.exception(f"[DGLabServer] <process_command> (LOG_ERROR): batch 第 {index} 条命令执行异常: {e}")
+                        results.append({"status": "error", "message": str(e)})
+                failed = sum(1 for item in results if item.get("status") != "ok")
+                logger.debug(f"[DGLabServer] <process_command> (LOG_DEBUG): batch 执行完成: {len(ops)} 条，失败 {failed} 条")
+                response = {
+                    "status": "ok" if failed == 0 else "partial",
+                    "message": f"已执行 {len(ops)} 条命令，失败 {failed} 条",
+                    "results": results
+                }
+
         # ---------- 连接相关 ----------
-        if cmd_type == "connect":
+        elif cmd_type == "connect":
             logger.info("[DGLabServer] <process_command> (LOG_INFO): 收到连接请求，开始连接 WebSocket 服务器...")
             success = await self.dglab.connect_async()
             response = {
@@ -321,10 +399,26 @@ class DGLabServer:
         async with self.server:
             await self.server.serve_forever()
 
+    async def start_ipc(self, path):
+        """
+        连接父进程监听的 Unix 域套接字（路径由 --ipc 传入）并在该连接上处理命令。
+        连接建立即表示就绪，无需输出端口；连接断开（父进程关闭或退出）后返回。
+        """
+        reader, writer = await asyncio.open_unix_connection(path)
+        logger.info(f"[DGLabServer] <start_ipc> (LOG_INFO): 已连接本地套接字: {path}")
+        await self.handle_qt_client(reader, writer)
+
 
 async def main():
+    parser = argparse.ArgumentParser(description="DG-LAB 桥接服务")
+    parser.add_argument("--ipc", metavar="PATH", help="连接父进程的 Unix 域套接字（省略时监听 TCP 回环端口并输出端口号）")
+    args = parser.parse_args()
+
     server = DGLabServer()
-    await server.start_server()
+    if args.ipc:
+        await server.start_ipc(args.ipc)
+    else:
+        await server.start_server()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,183 @@
+"""
+    Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+    SPDX-License-Identifier: GPL-3.0-only
+"""
+
+import asyncio
+import struct
+
+# CBOR（RFC 8949）最小实现，仅覆盖桥接消息用到的类型:
+# None、bool、int（64 位范围内）、float、str、bytes、list、dict
+# 与 C++ 端 QCborValue 互通；帧格式为 4 字节大端长度 + CBOR 负载
+
+FRAME_HEADER = struct.Struct(">I")  # 帧头: 负载字节数（大端 uint32）
+MAX_FRAME_BYTES = 16 * 1024 * 1024  # 单帧上限，超过视为流损坏
+
+_FLOAT16 = struct.Struct(">e")
+_FLOAT32 = struct.Struct(">f")
+_FLOAT64 = struct.Struct(">d")
+
+
+class CborDecodeError(ValueError):
+    """CBOR 数据损坏或包含不支持的类型"""
+
+
+class CborFrameError(CborDecodeError):
+    """帧头损坏（长度超限），流已无法恢复同步"""
+
+
+def _encode_head(out, major, value):
+    """写入主类型与长度/数值（按最短形式）"""
+    if value < 24:
+        out.append((major << 5) | value)
+    elif value < 0x100:
+        out += bytes(((major << 5) | 24, value))
+    elif value < 0x10000:
+        out.append((major << 5) | 25)
+        out += value.to_bytes(2, "big")
+    elif value < 0x100000000:
+        out.append((major << 5) | 26)
+        out += value.to_bytes(4, "big")
+    else:
+        out.append((major << 5) | 27)
+        out += value.to_bytes(8, "big")
+
+
+def _encode(out, obj):
+    # bool 是 int 的子类，须先判断
+    if obj is None:
+        out.append(0xF6)
+    elif obj is True:
+        out.append(0xF5)
+    elif obj is False:
+        out.append(0xF4)
+    elif isinstance(obj, int):
+        if obj >= 0:
+            _encode_head(out, 0, obj)
+        else:
+            _encode_head(out, 1, -1 - obj)
+    elif isinstance(obj, float):
+        out.append(0xFB)
+        out += _FLOAT64.pack(obj)
+    elif isinstance(obj, str):
+        data = obj.encode("utf-8")
+        _encode_head(out, 3, len(data))
+        out += data
+    elif isinstance(obj, (bytes, bytearray)):
+        _encode_head(out, 2, len(obj))
+        out += obj
+    elif isinstance(obj, (list, tuple)):
+        _encode_head(out, 4, len(obj))
+        for item in obj:
+            _encode(out, item)
+    elif isinstance(obj, dict):
+        _encode_head(out, 5, len(obj))
+        for key, value in obj.items():
+            _encode(out, str(key))
+            _encode(out, value)
+    else:
+        raise TypeError(f"CBOR 不支持的类型: {type(obj).__name__}")
+
+
+def dumps(obj):
+    """将对象编码为 CBOR 字节串"""
+    out = bytearray()
+    _encode(out, obj)
+    return bytes(out)
+
+
+def _decode(data, pos):
+    """从 data[pos] 解码一个数据项，返回 (对象, 新位置)"""
+    if pos >= len(data):
+        raise CborDecodeError("数据不完整")
+    initial = data[pos]
+    pos += 1
+    major = initial >> 5
+    info = initial & 0x1F
+
+    if major == 7:
+        if info == 20:
+            return False, pos
+        if info == 21:
+            return True, pos
+        if info in (22, 23):
+            return None, pos
+        if info == 25:
+            return _FLOAT16.unpack_from(data, pos)[0], pos + 2
+        if info == 26:
+            return _FLOAT32.unpack_from(data, pos)[0], pos + 4
+        if info == 27:
+            return _FLOAT64.unpack_from(data, pos)[0], pos + 8
+        raise CborDecodeError(f"不支持的简单值: {info}")
+
+    if info < 24:
+        value = info
+    elif info <= 27:
+        size = 1 << (info - 24)
+        if pos + size > len(data):
+            raise CborDecodeError("数据不完整")
+        value = int.from_bytes(data[pos:pos + size], "big")
+        pos += size
+    else:
+        raise CborDecodeError("不支持不定长编码")
+
+    if major == 0:
+        return value, pos
+    if major == 1:
+        return -1 - value, pos
+    if major in (2, 3):
+        if pos + value > len(data):
+            raise CborDecodeError("数据不完整")
+        chunk = bytes(data[pos:pos + value])
+        return (chunk if major == 2 else chunk.decode("utf-8")), pos + value
+    if major == 4:
+        items = []
+        for _ in range(value):
+            item, pos = _decode(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        result = {}
+        for _ in range(value):
+            key, pos = _decode(data, pos)
+            result[key], pos = _decode(data, pos)
+        return result, pos
+    # major == 6: 标签，忽略标签号，返回被标记的数据项
+    return _decode(data, pos)
+
+
+def loads(data):
+    """将 CBOR 字节串解码为对象（须恰好包含一个数据项）"""
+    try:
+        obj, pos = _decode(data, 0)
+    except (struct.error, UnicodeDecodeError) as e:
+        raise CborDecodeError(str(e)) from e
+    if pos != len(data):
+        raise CborDecodeError("数据项之后有多余字节")
+    return obj
+
+
+def encode_frame(obj):
+    """编码为一帧（长度前缀 + CBOR 负载）"""
+    payload = dumps(obj)
+    return FRAME_HEADER.pack(len(payload)) + payload
+
+
+async def read_frame(reader):
+    """
+    从 asyncio.StreamReader 读取一帧并解码，连接关闭时返回 None。
+    负载无法解码时抛出 CborDecodeError（可跳过该帧继续读取）；
+    帧长度超过 MAX_FRAME_BYTES 时抛出 CborFrameError（流已无法恢复同步）。
+    """
+    try:
+        header = await reader.readexactly(FRAME_HEADER.size)
+    except asyncio.IncompleteReadError:
+        return None
+    (length,) = FRAME_HEADER.unpack(header)
+    if length > MAX_FRAME_BYTES:
+        raise CborFrameError(f"帧长度 {length} 超过上限")
+    try:
+        payload = await reader.readexactly(length)
+    except asyncio.IncompleteReadError:
+        return None
+    return loads(payload)
@@ -0,0 +1,144 @@
+"""
+    Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+    SPDX-License-Identifier: GPL-3.0-only
+"""
+
+import argparse
+import glob
+import http.client
+import json
+import logging
+import os
+import random
+import sys
+import time
+
+# 配置日志: INFO级别，包含时间、级别、消息
+logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+logger = logging.getLogger("gsi_replay")  # 独立的日志记录器
+
+
+def load_recording(path):
+    """
+    读取录制的 GSI 负载，返回 [(相对时间秒, 负载文本), ...]
+    支持三种格式:
+      - JSON Lines 文件: 每行 {"t": 秒, "payload": {...}}，或每行直接为一个负载对象
+      - 单个 JSON 文件: 一个负载对象
+      - 目录: 按文件名排序的 *.json 文件，每个文件一个负载
+    无时间戳的负载按 None 返回，由 --interval 决定间隔
+    """
+    if os.path.isdir(path):
+        files = sorted(glob.glob(os.path.join(path, "*.json")))
+        return [(None, open(f, encoding="utf-8").read()) for f in files]
+
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    try:
+        return [(None, json.dumps(json.loads(text)))]
+    except json.JSONDecodeError:
+        pass
+
+    frames = []
+    for line_no, line in enumerate(text.splitlines(), 1):
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            obj = json.loads(line)
+        except json.JSONDecodeError as e:
+            logger.warning(f"第 {line_no} 行不是合法 JSON，已跳过: {e}")
+            continue
+        if isinstance(obj, dict) and "payload" in obj:
+            frames.append((obj.get("t"), json.dumps(obj["payload"])))
+        else:
+            frames.append((None, json.dumps(obj)))
+    return frames
+
+
+def synthesize(count, token):
+    """
+    生成模拟负载（血量随机下降、回合开始回满、金钱递增），用于无录制文件时的联调
+    """
+    frames = []
+    health, money = 100, 800
+    for i in range(count):
+        health = 100 if health <= 0 else max(0, health - random.choice((0, 0, 5, 13, 27)))
+        money = min(16000, money + random.choice((0, 0, 300)))
+        payload = {
+            "provider": {"name": "Counter-Strike 2", "appid": 730, "timestamp": int(time.time()) + i},
+            "player": {
+                "steamid": "0",
+                "team": "CT",
+                "state": {"health": health, "armor": 100 if health > 0 else 0, "helmet": True,
+                          "money": money, "defusekit": i % 2 == 0}
+            }
+        }
+        if token:
+            payload["auth"] = {"token": token}
+        frames.append((None, json.dumps(payload)))
+    return frames
+
+
+def replay(host, port, frames, interval, speed, loop):
+    """
+    通过同一个 keep-alive 连接依次 POST 负载（与 CS2 的推送方式一致）
+    有时间戳时按录制节奏回放（speed 倍速，0 表示不等待），否则每帧间隔 interval 秒
+    """
+    conn = http.client.HTTPConnection(host, port, timeout=5)
+    sent = 0
+    try:
+        while True:
+            start = time.monotonic()
+            first_t = next((t for t, _ in frames if t is not None), None)
+            for t, body in frames:
+                if t is not None and first_t is not None and speed > 0:
+                    delay = (t - first_t) / speed - (time.monotonic() - start)
+                    if delay > 0:
+                        time.sleep(delay)
+                conn.request("POST", "/", body=body.encode("utf-8"),
+                             headers={"Content-Type": "application/json"})
+                resp = conn.getresponse()
+                resp.read()
+                if resp.status != 200:
+                    logger.warning(f"第 {sent + 1} 帧返回 {resp.status} {resp.reason}")
+                sent += 1
+                if t is None and interval > 0:
+                    time.sleep(interval)
+            if not loop:
+                break
+    finally:
+        conn.close()
+    return sent
+
+
+def main():
+    parser = argparse.ArgumentParser(description="向 DG-LAB-Client 的 GSI 接收端回放 CS2 GSI 负载")
+    parser.add_argument("recording", nargs="?", help="录制文件（JSON/JSON Lines）或目录；省略时生成模拟负载")
+    parser.add_argument("--host", default="127.0.0.1", help="接收端地址（默认 127.0.0.1）")
+    parser.add_argument("--port", type=int, default=3000, help="接收端端口（默认 3000，对应 app.gsi.port）")
+    parser.add_argument("--interval", type=float, default=0.1, help="无时间戳负载的发送间隔（秒，默认 0.1）")
+    parser.add_argument("--speed", type=float, default=1.0, help="按时间戳回放的倍速（0 表示不等待，尽快发送）")
+    parser.add_argument("--count", type=int, default=100, help="模拟负载数量（默认 100）")
+    parser.add_argument("--token", default="", help="模拟负载携带的 auth.token（对应 app.gsi.token）")
+    parser.add_argument("--loop", action="store_true", help="循环回放")
+    args = parser.parse_args()
+
+    frames = load_recording(args.recording) if args.recording else synthesize(args.count, args.token)
+    if not frames:
+        logger.error("没有可回放的负载")
+        return 1
+    logger.info(f"开始回放 {len(frames)} 帧 → http://{args.host}:{args.port}/")
+    begin = time.monotonic()
+    try:
+        sent = replay(args.host, args.port, frames, args.interval, args.speed, args.loop)
+    except (ConnectionError, OSError) as e:
+        logger.error(f"连接接收端失败: {e}")
+        return 1
+    except KeyboardInterrupt:
+        return 0
+    logger.info(f"回放完成: {sent} 帧，耗时 {time.monotonic() - begin:.2f}s")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
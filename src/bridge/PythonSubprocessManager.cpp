@@ -7,15 +7,20 @@
 
 #include "DebugLog.h"
 
+#include <QCborMap>
+#include <QCborValue>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QRegularExpression>
 #include <QTcpSocket>
-#include <QThreadPool>
+#include <QThread>
 #include <QTimer>
+#include <QtEndian>
 
 #include <iostream>
+#include <vector>
 
 // ============================================
 // 构造/析构（public）
@@ -24,19 +29,27 @@
 PythonSubprocessManager::PythonSubprocessManager(QObject* parent)
     : QObject(parent)
     , process_(new QProcess(this))
-    , socket_(new QTcpSocket(this))
+    , tcp_socket_(new QTcpSocket(this))
+    , connect_timer_(new QTimer(this))
     , port_(0)
-    , response_received_(false) {
+    , timeout_timer_(new QTimer(this)) {
     LOG_MODULE("PythonSubprocessManager", "PythonSubprocessManager", LOG_INFO, "创建对象");
+    // 超时扫描只在有待响应请求时运行
+    clock_.start();
+    timeout_timer_->setInterval(TIMEOUT_SWEEP_INTERVAL_MS);
+    connect(timeout_timer_, &QTimer::timeout, this, &PythonSubprocessManager::on_timeout_sweep);
 
     connect(process_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
         this, &PythonSubprocessManager::on_process_finished);
     connect(process_, &QProcess::errorOccurred, this, &PythonSubprocessManager::on_process_error);
     connect(process_, &QProcess::started, this, &PythonSubprocessManager::on_process_started);
 
-    connect(socket_, &QTcpSocket::connected, this, &PythonSubprocessManager::on_socket_connected);
-    connect(socket_, &QTcpSocket::errorOccurred, this, &PythonSubprocessManager::on_socket_error);
-    connect(socket_, &QTcpSocket::readyRead, this, &PythonSubprocessManager::on_socket_ready_read);
+    connect(tcp_socket_, &QTcpSocket::connected, this, &PythonSubprocessManager::on_socket_connected);
+    connect(tcp_socket_, &QTcpSocket::errorOccurred, this, &PythonSubprocessManager::on_socket_error);
+    connect(tcp_socket_, &QTcpSocket::readyRead, this, &PythonSubprocessManager::on_socket_ready_read);
+
+    connect_timer_->setSingleShot(true);
+    connect(connect_timer_, &QTimer::timeout, this, &PythonSubprocessManager::on_local_connect_timeout);
 
     connect(process_, &QProcess::readyReadStandardOutput, this, &PythonSubprocessManager::handle_stdout);
     connect(process_, &QProcess::readyReadStandardError, this, &PythonSubprocessManager::handle_stderr);
@@ -46,17 +59,16 @@ PythonSubprocessManager::~PythonSubprocessManager() {
     LOG_MODULE("PythonSubprocessManager", "~PythonSubprocessManager", LOG_INFO, "析构，清理资源");
 
     stopping_ = true;
-    {
-        QMutexLocker locker(&mutex_);
-        wait_cond_.wakeAll();
-    }
+    // 待响应请求的回调可能引用已销毁的对象，直接丢弃
+    timeout_timer_->stop();
+    pending_.clear();
+    queued_.clear();
 
     // 断开信号连接，避免析构过程中触发槽
     if (process_) process_->disconnect(this);
-    if (socket_) socket_->disconnect(this);
-
-    // 等待线程池中任务完成
-    QThreadPool::globalInstance()->waitForDone(3000);
+    if (tcp_socket_) tcp_socket_->disconnect(this);
+    if (local_socket_) local_socket_->disconnect(this);
+    if (local_server_) local_server_->disconnect(this);
 
     // 终止子进程
     if (process_->state() != QProcess::NotRunning) {
@@ -68,9 +80,17 @@ PythonSubprocessManager::~PythonSubprocessManager() {
     }
 
     // 断开 socket
-    if (socket_->state() == QTcpSocket::ConnectedState) {
-        socket_->disconnectFromHost();
-        socket_->waitForDisconnected(1000);
+    if (tcp_socket_->state() == QTcpSocket::ConnectedState) {
+        tcp_socket_->disconnectFromHost();
+        tcp_socket_->waitForDisconnected(1000);
+    }
+    if (local_socket_ && local_socket_->state() == QLocalSocket::ConnectedState) {
+        local_socket_->disconnectFromServer();
+        local_socket_->waitForDisconnected(1000);
+    }
+    // 关闭服务端（删除套接字文件）
+    if (local_server_) {
+        local_server_->close();
     }
 }
 
@@ -78,8 +98,22 @@ PythonSubprocessManager::~PythonSubprocessManager() {
 // 公共接口（public）
 // ============================================
 
-void PythonSubprocessManager::start_process(const QString& python_executable, const QString& script_path) {
+void PythonSubprocessManager::start_process(const QString& python_executable, const QString& script_path, Transport transport) {
     port_ = 0;
+    connected_ = false;
+
+#ifdef Q_OS_WIN
+    // Windows 下 QLocalServer 为命名管道，Python asyncio 无对应的公开客户端接口，使用 TCP
+    if (transport == Transport::LOCAL) {
+        LOG_MODULE("PythonSubprocessManager", "start_process", LOG_WARN, "Windows 不支持本地套接字传输，回退为 TCP");
+    }
+    transport_ = Transport::TCP;
+#else
+    transport_ = transport == Transport::TCP ? Transport::TCP : Transport::LOCAL;
+#endif
+    if (transport_ == Transport::LOCAL && !listen_local()) {
+        transport_ = Transport::TCP;
+    }
 
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("PYTHONIOENCODING", "utf-8");
@@ -87,6 +121,16 @@ void PythonSubprocessManager::start_process(const QString& python_executable, co
 
     QStringList args;
     args << script_path;
+    if (transport_ == Transport::LOCAL) {
+        args << "--ipc" << local_server_->fullServerName();
+    }
+    if (transport_ == Transport::LOCAL) {
+        LOG_MODULE("PythonSubprocessManager", "start_process", LOG_INFO,
+            "传输方式: 本地套接字 " << local_server_->fullServerName().toStdString());
+    }
+    else {
+        LOG_MODULE("PythonSubprocessManager", "start_process", LOG_INFO, "传输方式: TCP");
+    }
     process_->start(python_executable, args);
     if (!process_->waitForStarted(5000)) {
         LOG_MODULE("PythonSubprocessManager", "start_process", LOG_ERROR, "启动失败（超时）");
@@ -94,7 +138,21 @@ void PythonSubprocessManager::start_process(const QString& python_executable, co
     }
     else {
         LOG_MODULE("PythonSubprocessManager", "start_process", LOG_DEBUG, "waitForStarted 成功，等待进程启动信号");
+        if (transport_ == Transport::LOCAL) {
+            connect_timer_->start(LOCAL_CONNECT_TIMEOUT_MS);
+        }
+    }
+}
+
+PythonSubprocessManager::Transport PythonSubprocessManager::transport_from_string(const QString& name) {
+    QString lower = name.trimmed().toLower();
+    if (lower == "local") {
+        return Transport::LOCAL;
+    }
+    if (lower == "tcp") {
+        return Transport::TCP;
     }
+    return Transport::AUTO;
 }
 
 void PythonSubprocessManager::call(const QJsonObject& cmd, std::function<void(const QJsonObject&)> callback, int timeout) {
@@ -103,36 +161,25 @@ void PythonSubprocessManager::call(const QJsonObject& cmd, std::function<void(co
         if (callback) callback({{"status", "error"}, {"message", "对象正在销毁"}});
         return;
     }
-
-    int token = ++next_token_;
-    {
-        QMutexLocker locker(&callback_mutex_);
-        pending_callbacks_[token] = callback;
+    if (QThread::currentThread() != thread()) {
+        // 待响应表与套接字只在所属线程访问
+        QMetaObject::invokeMethod(this, [this, cmd, callback = std::move(callback), timeout]() mutable {
+            call(cmd, std::move(callback), timeout); }, Qt::QueuedConnection);
+        return;
     }
 
+    int token = ++next_token_;
     QJsonObject cmd_with_token = cmd;
     cmd_with_token["req_id"] = token;
+    pending_[token] = PendingCall{ std::move(callback), clock_.elapsed() + timeout, false };
+    queued_.emplace_back(token, std::move(cmd_with_token));
 
-    std::string cmd_str = DebugLogUtil::remove_newline(QJsonDocument(cmd_with_token).toJson().toStdString());
     LOG_MODULE("PythonSubprocessManager", "call", LOG_DEBUG,
-        "异步调用，token=" << token << "，命令: " << cmd_str);
-
-    QThreadPool::globalInstance()->start([this, cmd_with_token, timeout, token]() {
-        if (stopping_) return;
-
-        QJsonObject response = send_command(cmd_with_token, timeout);
-        QMetaObject::invokeMethod(this, [this, token, response]() {
-            std::function<void(const QJsonObject&)> cb;
-            {
-                QMutexLocker locker(&callback_mutex_);
-                auto it = pending_callbacks_.find(token);
-                if (it != pending_callbacks_.end()) {
-                    cb = it.value();
-                    pending_callbacks_.erase(it);
-                }
-            }
-            if (cb) cb(response); }, Qt::QueuedConnection);
-    });
+        "异步调用，token=" << token << "，超时=" << timeout << "ms，在途 " << in_flight_count_ << " 个");
+    pump_queue();
+    if (!timeout_timer_->isActive()) {
+        timeout_timer_->start();
+    }
 }
 
 // ============================================
@@ -174,7 +221,7 @@ void PythonSubprocessManager::process_output(const QByteArray& data, bool is_err
 }
 
 void PythonSubprocessManager::parse_port_from_output(const QByteArray& data) {
-    if (port_ != 0) return;
+    if (transport_ != Transport::TCP || port_ != 0) return;
 
     QString output = QString::fromUtf8(data).trimmed();
     bool ok;
@@ -183,7 +230,7 @@ void PythonSubprocessManager::parse_port_from_output(const QByteArray& data) {
         port_ = port;
         LOG_MODULE("PythonSubprocessManager", "parse_port_from_output", LOG_INFO,
             "解析到 TCP 端口: " << port);
-        socket_->connectToHost(QHostAddress::LocalHost, port_);
+        tcp_socket_->connectToHost(QHostAddress::LocalHost, port_);
     }
     else {
         LOG_MODULE("PythonSubprocessManager", "parse_port_from_output", LOG_DEBUG,
@@ -191,51 +238,177 @@ void PythonSubprocessManager::parse_port_from_output(const QByteArray& data) {
     }
 }
 
-void PythonSubprocessManager::send_json(const QJsonObject& obj) {
-    QByteArray data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
-    data.append('\n');
-    LOG_MODULE("PythonSubprocessManager", "send_json", LOG_DEBUG,
-        "发送 JSON: " << DebugLogUtil::remove_newline(data.toStdString()));
-    socket_->write(data);
-    socket_->flush();
+bool PythonSubprocessManager::listen_local() {
+    // 名称含进程号与序号，避免多实例冲突；非绝对路径时 Qt 放在临时目录下
+    static int serial = 0;
+    QString name = QString("dglab-bridge-%1-%2").arg(QCoreApplication::applicationPid()).arg(++serial);
+    QLocalServer::removeServer(name);
+
+    if (!local_server_) {
+        local_server_ = new QLocalServer(this);
+        local_server_->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(local_server_, &QLocalServer::newConnection, this, &PythonSubprocessManager::on_local_new_connection);
+    }
+    if (!local_server_->listen(name)) {
+        LOG_MODULE("PythonSubprocessManager", "listen_local", LOG_WARN,
+            "本地套接字监听失败，回退为 TCP: " << local_server_->errorString().toStdString());
+        return false;
+    }
+    return true;
 }
 
-QJsonObject PythonSubprocessManager::send_command(const QJsonObject& cmd, int timeout) {
-    QMutexLocker locker(&mutex_);
-    response_received_ = false;
-    last_response_ = QJsonObject();
+void PythonSubprocessManager::abort_socket() {
+    if (socket_ == tcp_socket_) {
+        tcp_socket_->abort();
+    }
+    else if (local_socket_) {
+        local_socket_->abort();
+    }
+    connected_ = false;
+}
 
-    std::string message = DebugLogUtil::remove_newline(QJsonDocument(cmd).toJson().toStdString());
-    LOG_MODULE("PythonSubprocessManager", "send_command", LOG_DEBUG,
-        "发送命令，等待响应，超时=" << timeout << "ms，命令: " << message);
+void PythonSubprocessManager::handle_socket_error() {
+    QString error = socket_ ? socket_->errorString() : QString("未连接");
+    connected_ = false;
+    fail_all_pending("与 Python 服务的连接出错: " + error);
+    emit started(false, error);
+}
 
-    bool sent = false;
-    QMetaObject::invokeMethod(this, [this, cmd, &sent]() {
-        send_json(cmd);
-        sent = true; }, Qt::BlockingQueuedConnection);
-    if (!sent) {
-        return {{"status", "error"}, {"message", "发送命令失败"}};
+void PythonSubprocessManager::send_message(const QJsonObject& obj) {
+    QByteArray data;
+    if (frame_format_ == FrameFormat::CBOR) {
+        QByteArray payload = QCborMap::fromJsonObject(obj).toCborValue().toCbor();
+        data.resize(FRAME_HEADER_SIZE);
+        qToBigEndian<quint32>(static_cast<quint32>(payload.size()), data.data());
+        data.append(payload);
+    }
+    else {
+        data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+        data.append('\n');
+    }
+    // 日志内容仅在调试级别启用时才序列化
+    LOG_MODULE("PythonSubprocessManager", "send_message", LOG_DEBUG,
+        "发送 " << (frame_format_ == FrameFormat::CBOR ? "CBOR" : "JSON") << "（" << data.size() << " 字节）: "
+        << QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString());
+    socket_->write(data);
+    if (socket_ == tcp_socket_) {
+        tcp_socket_->flush();
+    }
+    else {
+        local_socket_->flush();
     }
+}
+
+void PythonSubprocessManager::negotiate_format() {
+    frame_format_ = FrameFormat::JSON;
+    negotiating_ = true;
 
-    while (!response_received_ && !stopping_) {
-        if (!wait_cond_.wait(&mutex_, timeout)) {
-            if (stopping_) {
-                LOG_MODULE("PythonSubprocessManager", "send_command", LOG_DEBUG, "对象正在销毁，停止等待");
-                return {{"status", "error"}, {"message", "对象正在销毁"}};
+    // hello 绕过排队直接发送；旧版 Bridge.py 对未知命令返回错误（带 req_id），按 JSON 继续
+    int token = ++next_token_;
+    QJsonObject hello{
+        {"cmd", "hello"},
+        {"req_id", token},
+        {"formats", QJsonArray{"cbor", "json"}}
+    };
+    auto on_hello = [this](const QJsonObject& response) {
+        if (!response.contains("req_id")) {
+            // 本地生成的错误响应（超时或连接已断开）：对端可能已切换格式，无法再按 JSON 继续通信
+            negotiating_ = false;
+            if (connected_) {
+                LOG_MODULE("PythonSubprocessManager", "negotiate_format", LOG_ERROR,
+                    "消息格式协商超时（" << HELLO_TIMEOUT_MS << "ms），断开连接");
+                abort_socket();
+                fail_all_pending("与 Python 服务的消息格式协商超时");
+                emit started(false, "与 Python 服务的消息格式协商超时");
             }
-            LOG_MODULE("PythonSubprocessManager", "send_command", LOG_WARN,
-                "等待响应超时 (" << timeout << "ms)");
-            return {{"status", "error"}, {"message", "响应超时"}};
+            return;
         }
+        // 在 on_socket_ready_read 的读取循环中调用：切换后同一缓冲区中的后续数据即按新格式解析
+        if (response.value("status").toString() == "ok" && response.value("format").toString() == "cbor") {
+            frame_format_ = FrameFormat::CBOR;
+        }
+        negotiating_ = false;
+        LOG_MODULE("PythonSubprocessManager", "negotiate_format", LOG_INFO,
+            "消息格式协商完成: " << (frame_format_ == FrameFormat::CBOR ? "CBOR" : "JSON"));
+        pump_queue();
+    };
+    pending_[token] = PendingCall{ std::move(on_hello), clock_.elapsed() + HELLO_TIMEOUT_MS, true };
+    ++in_flight_count_;
+    send_message(hello);
+    if (!timeout_timer_->isActive()) {
+        timeout_timer_->start();
     }
+}
 
-    if (stopping_) {
-        return {{"status", "error"}, {"message", "对象正在销毁"}};
+void PythonSubprocessManager::handle_message(const QJsonObject& obj) {
+    // 检查是否有 req_id 字段
+    if (obj.contains("req_id")) {
+        int token = obj.value("req_id").toInt();
+        LOG_MODULE("PythonSubprocessManager", "handle_message", LOG_DEBUG,
+            "收到响应，token=" << token << "，内容: " << QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString());
+        // 按 req_id 回调对应的请求（已超时的请求已移除，其响应丢弃）
+        complete_call(token, obj);
+        emit command_response(token, obj);
+    }
+    else {
+        // 主动消息（无 req_id）
+        LOG_MODULE("PythonSubprocessManager", "handle_message", LOG_DEBUG,
+            "收到主动消息: " << QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString());
+        emit active_message_received(obj);
     }
+}
+
+void PythonSubprocessManager::pump_queue() {
+    // 未连接时请求留在队列中，直到连接建立（协商结束后补发）或超时
+    if (!connected_ || !socket_) {
+        return;
+    }
+    // 协商期间消息格式未定，排队请求等协商结束后发送
+    while (!negotiating_ && in_flight_count_ < MAX_IN_FLIGHT && !queued_.empty()) {
+        auto [token, cmd] = std::move(queued_.front());
+        queued_.pop_front();
+        auto it = pending_.find(token);
+        if (it == pending_.end()) {
+            continue; // 排队期间已超时
+        }
+        it->second.sent = true;
+        ++in_flight_count_;
+        send_message(cmd);
+    }
+}
 
-    std::string respond_str = DebugLogUtil::remove_newline(QJsonDocument(last_response_).toJson().toStdString());
-    LOG_MODULE("PythonSubprocessManager", "send_command", LOG_DEBUG, "收到响应: " << respond_str);
-    return last_response_;
+void PythonSubprocessManager::complete_call(int token, const QJsonObject& response) {
+    auto it = pending_.find(token);
+    if (it == pending_.end()) {
+        LOG_MODULE("PythonSubprocessManager", "complete_call", LOG_DEBUG,
+            "响应对应的请求已超时或不存在，丢弃，token=" << token);
+        return;
+    }
+    PendingCall call = std::move(it->second);
+    pending_.erase(it);
+    if (call.sent) {
+        --in_flight_count_;
+    }
+    if (pending_.empty()) {
+        timeout_timer_->stop();
+    }
+    // 先补发排队请求再回调：回调中发起的新调用排在已排队请求之后
+    pump_queue();
+    if (call.callback) {
+        call.callback(response);
+    }
+}
+
+void PythonSubprocessManager::fail_all_pending(const QString& message) {
+    std::vector<int> tokens;
+    tokens.reserve(pending_.size());
+    for (const auto& [token, call] : pending_) {
+        tokens.push_back(token);
+    }
+    queued_.clear();
+    for (int token : tokens) {
+        complete_call(token, {{"status", "error"}, {"message", message}});
+    }
 }
 
 // ============================================
@@ -255,54 +428,136 @@ void PythonSubprocessManager::on_process_error(QProcess::ProcessError error) {
 void PythonSubprocessManager::on_process_finished(int exit_code, QProcess::ExitStatus status) {
     LOG_MODULE("PythonSubprocessManager", "on_process_finished", LOG_INFO,
         "进程结束，exitCode=" << exit_code << "，status=" << (status == QProcess::NormalExit ? "Normal" : "Crash"));
+    connect_timer_->stop();
+    connected_ = false;
+    fail_all_pending("Python 进程已退出");
     emit finished();
 }
 
 void PythonSubprocessManager::on_socket_connected() {
-    LOG_MODULE("PythonSubprocessManager", "on_socket_connected", LOG_INFO,
-        "TCP socket 已连接到端口 " << port_);
+    if (transport_ == Transport::TCP) {
+        socket_ = tcp_socket_;
+        LOG_MODULE("PythonSubprocessManager", "on_socket_connected", LOG_INFO,
+            "TCP socket 已连接到端口 " << port_);
+    }
+    else {
+        LOG_MODULE("PythonSubprocessManager", "on_socket_connected", LOG_INFO, "Python 已连接本地套接字");
+    }
+    connected_ = true;
+    negotiate_format();
     emit started(true, QString());
 }
 
 void PythonSubprocessManager::on_socket_error(QTcpSocket::SocketError error) {
     LOG_MODULE("PythonSubprocessManager", "on_socket_error", LOG_ERROR,
-        "Socket 错误: " << socket_->errorString().toStdString() << " (error=" << error << ")");
-    emit started(false, socket_->errorString());
+        "Socket 错误: " << tcp_socket_->errorString().toStdString() << " (error=" << error << ")");
+    handle_socket_error();
 }
 
 void PythonSubprocessManager::on_socket_ready_read() {
-    while (socket_->canReadLine()) {
-        QByteArray line = socket_->readLine();
-        std::string line_str = DebugLogUtil::remove_newline(line.toStdString());
-        QJsonParseError err;
-        QJsonDocument doc = QJsonDocument::fromJson(line, &err);
-        if (err.error != QJsonParseError::NoError) {
-            LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_WARN,
-                "JSON 解析错误: " << err.errorString().toStdString() << "，原始数据: " << line_str);
-            continue;
-        }
-        QJsonObject obj = doc.object();
-
-        // 检查是否有 req_id 字段
-        if (obj.contains("req_id")) {
-            int token = obj.value("req_id").toInt();
-            LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_DEBUG,
-                "收到响应，token=" << token);
-            {
-                QMutexLocker locker(&mutex_);
-                last_response_ = obj;
-                response_received_ = true;
-                wait_cond_.wakeAll();
+    if (!socket_) {
+        return;
+    }
+    // 每轮按当前格式解码一条消息；hello 响应处理后格式可能切换，后续数据按新格式解析
+    while (true) {
+        if (frame_format_ == FrameFormat::CBOR) {
+            if (socket_->bytesAvailable() < FRAME_HEADER_SIZE) {
+                break;
+            }
+            QByteArray header = socket_->peek(FRAME_HEADER_SIZE);
+            quint32 length = qFromBigEndian<quint32>(header.constData());
+            if (length > MAX_FRAME_BYTES) {
+                LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_ERROR,
+                    "CBOR 帧长度 " << length << " 超过上限，帧流已损坏，断开连接");
+                abort_socket();
+                fail_all_pending("与 Python 服务的帧流已损坏");
+                return;
             }
-            emit command_response(token, obj);
+            if (socket_->bytesAvailable() < FRAME_HEADER_SIZE + length) {
+                break; // 等待整帧到达
+            }
+            socket_->read(FRAME_HEADER_SIZE);
+            QCborParserError err;
+            QCborValue value = QCborValue::fromCbor(socket_->read(length), &err);
+            if (err.error != QCborError::NoError || !value.isMap()) {
+                LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_WARN,
+                    "CBOR 帧解析错误: " << err.error.toString().toStdString() << "，长度 " << length);
+                continue;
+            }
+            handle_message(value.toMap().toJsonObject());
         }
         else {
-            // 主动消息（无 req_id）
-            LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_DEBUG,
-                "收到主动消息: " << DebugLogUtil::remove_newline(line.toStdString()));
-            emit active_message_received(obj);
+            if (!socket_->canReadLine()) {
+                break;
+            }
+            QByteArray line = socket_->readLine();
+            QJsonParseError err;
+            QJsonDocument doc = QJsonDocument::fromJson(line, &err);
+            if (err.error != QJsonParseError::NoError) {
+                LOG_MODULE("PythonSubprocessManager", "on_socket_ready_read", LOG_WARN,
+                    "JSON 解析错误: " << err.errorString().toStdString()
+                    << "，原始数据: " << DebugLogUtil::remove_newline(line.toStdString()));
+                continue;
+            }
+            handle_message(doc.object());
+        }
+    }
+}
+
+void PythonSubprocessManager::on_local_new_connection() {
+    QLocalSocket* socket = local_server_->nextPendingConnection();
+    if (!socket) {
+        return;
+    }
+    if (local_socket_) {
+        // 只接受一个连接（Python 子进程），之后的连接直接关闭
+        LOG_MODULE("PythonSubprocessManager", "on_local_new_connection", LOG_WARN, "已有连接，拒绝额外的本地套接字连接");
+        socket->abort();
+        socket->deleteLater();
+        return;
+    }
+    connect_timer_->stop();
+    local_socket_ = socket;
+    socket_ = local_socket_;
+    connect(local_socket_, &QLocalSocket::errorOccurred, this, &PythonSubprocessManager::on_local_socket_error);
+    connect(local_socket_, &QLocalSocket::readyRead, this, &PythonSubprocessManager::on_socket_ready_read);
+    // 连接建立即表示 Python 已就绪；服务端不再需要，关闭以删除套接字文件
+    local_server_->close();
+    on_socket_connected();
+    // 连接前已到达的数据不会再触发 readyRead
+    if (local_socket_->bytesAvailable() > 0) {
+        on_socket_ready_read();
+    }
+}
+
+void PythonSubprocessManager::on_local_socket_error(QLocalSocket::LocalSocketError error) {
+    LOG_MODULE("PythonSubprocessManager", "on_local_socket_error", LOG_ERROR,
+        "本地套接字错误: " << local_socket_->errorString().toStdString() << " (error=" << error << ")");
+    handle_socket_error();
+}
+
+void PythonSubprocessManager::on_local_connect_timeout() {
+    if (connected_) {
+        return;
+    }
+    LOG_MODULE("PythonSubprocessManager", "on_local_connect_timeout", LOG_ERROR,
+        "等待 Python 连接本地套接字超时（" << LOCAL_CONNECT_TIMEOUT_MS << "ms）");
+    emit started(false, "等待 Python 服务连接超时");
+}
+
+void PythonSubprocessManager::on_timeout_sweep() {
+    qint64 now = clock_.elapsed();
+    std::vector<int> expired;
+    for (const auto& [token, call] : pending_) {
+        if (call.deadline_ms <= now) {
+            expired.push_back(token);
         }
     }
+    // 先收集再完成：回调中可能发起新调用修改待响应表
+    for (int token : expired) {
+        LOG_MODULE("PythonSubprocessManager", "on_timeout_sweep", LOG_WARN, "等待响应超时，token=" << token);
+        complete_call(token, {{"status", "error"}, {"message", "响应超时"}});
+    }
 }
 
 void PythonSubprocessManager::handle_stdout() {
@@ -32,7 +32,8 @@ nlohmann::json DefaultConfigs::get_default_config(const std::string& config_name
             }},
             {"python", {
                 {"path", "python"},
-                {"bridge_path", "./python/Bridge.py"}
+                {"bridge_path", "./python/Bridge.py"},
+                {"transport", "auto"}
             }},
             {"rule", {
                 {"path", "./config/rules"},
@@ -49,7 +50,28 @@ nlohmann::json DefaultConfigs::get_default_config(const std::string& config_name
                 {"websocket", {
                     {"ip","127.0.0.1"},
                     {"port", 9999}
-                }}
+                }},
+                {"gsi", {
+                    {"enabled", true},
+                    {"port", 3000},
+                    {"token", ""}
+                }},
+                {"shm", {
+                    {"enabled", false},
+                    {"name", "dglab_values"},
+                    {"capacity", 4096}
+                }},
+                {"trace", {
+                    {"record_path", ""},
+                    {"replay_path", ""},
+                    {"replay_fast", false}
+                }},
+                {"adaptive_polling", {
+                    {"enabled", false},
+                    {"idle_polls", 8},
+                    {"max_period_ms", 8000}
+                }},
+                {"change_policy", nlohmann::json::object()}
             }},
             {"version", "1.0"},
             {"DGLABClient", "DG-LAB-Client"}
@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "GsiListener.h"
+
+#include "DebugLog.h"
+#include "ModuleManager.h"
+
+#include <QHostAddress>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <optional>
+#include <span>
+
+namespace {
+constexpr size_t MAX_JSON_DEPTH = 32;
+
+// JSON 标量叶子
+struct JsonLeaf {
+    enum class Type { NUMBER, STRING, BOOL, NULL_VALUE };
+    Type type = Type::NULL_VALUE;
+    double number = 0;       // NUMBER
+    std::string_view text;   // STRING：原始内容（未反转义）
+    bool boolean = false;    // BOOL
+};
+
+// 单遍流式 JSON 遍历：对每个标量叶子以 (路径, 值) 回调
+// 路径中的键与字符串值均为输入文本的视图（不反转义、不分配），数组元素的键为空
+template<typename OnLeaf>
+class JsonWalker {
+public:
+    JsonWalker(std::string_view text, OnLeaf& on_leaf)
+        : pos_(text.data())
+        , end_(text.data() + text.size())
+        , on_leaf_(on_leaf) {
+    }
+
+    // 遍历整个文本，格式错误或嵌套超过 MAX_JSON_DEPTH 返回 false
+    bool walk() {
+        skip_ws();
+        if (!parse_value()) {
+            return false;
+        }
+        skip_ws();
+        return pos_ == end_;
+    }
+
+private:
+    bool parse_value() {
+        if (pos_ == end_) {
+            return false;
+        }
+        JsonLeaf leaf;
+        switch (*pos_) {
+        case '{': return parse_object();
+        case '[': return parse_array();
+        case '"':
+            leaf.type = JsonLeaf::Type::STRING;
+            if (!parse_string(leaf.text)) {
+                return false;
+            }
+            break;
+        case 't':
+            leaf.type = JsonLeaf::Type::BOOL;
+            leaf.boolean = true;
+            if (!parse_literal("true")) {
+                return false;
+            }
+            break;
+        case 'f':
+            leaf.type = JsonLeaf::Type::BOOL;
+            if (!parse_literal("false")) {
+                return false;
+            }
+            break;
+        case 'n':
+            if (!parse_literal("null")) {
+                return false;
+            }
+            break;
+        default:
+            leaf.type = JsonLeaf::Type::NUMBER;
+            if (!parse_number(leaf.number)) {
+                return false;
+            }
+            break;
+        }
+        on_leaf_(std::span<const std::string_view>(path_.data(), depth_), leaf);
+        return true;
+    }
+
+    bool parse_object() {
+        if (depth_ >= MAX_JSON_DEPTH) {
+            return false;
+        }
+        ++pos_;
+        skip_ws();
+        if (pos_ != end_ && *pos_ == '}') {
+            ++pos_;
+            return true;
+        }
+        while (true) {
+            std::string_view key;
+            skip_ws();
+            if (!parse_string(key)) {
+                return false;
+            }
+            skip_ws();
+            if (pos_ == end_ || *pos_ != ':') {
+                return false;
+            }
+            ++pos_;
+            skip_ws();
+            path_[depth_++] = key;
+            bool ok = parse_value();
+            --depth_;
+            if (!ok) {
+                return false;
+            }
+            skip_ws();
+            if (pos_ == end_) {
+                return false;
+            }
+            if (*pos_ == '}') {
+                ++pos_;
+                return true;
+            }
+            if (*pos_ != ',') {
+                return false;
+            }
+            ++pos_;
+        }
+    }
+
+    bool parse_array() {
+        if (depth_ >= MAX_JSON_DEPTH) {
+            return false;
+        }
+        ++pos_;
+        skip_ws();
+        if (pos_ != end_ && *pos_ == ']') {
+            ++pos_;
+            return true;
+        }
+        while (true) {
+            skip_ws();
+            path_[depth_++] = std::string_view();
+            bool ok = parse_value();
+            --depth_;
+            if (!ok) {
+                return false;
+            }
+            skip_ws();
+            if (pos_ == end_) {
+                return false;
+            }
+            if (*pos_ == ']') {
+                ++pos_;
+                return true;
+            }
+            if (*pos_ != ',') {
+                return false;
+            }
+            ++pos_;
+        }
+    }
+
+    bool parse_string(std::string_view& out) {
+        if (pos_ == end_ || *pos_ != '"') {
+            return false;
+        }
+        const char* begin = ++pos_;
+        while (pos_ != end_ && *pos_ != '"') {
+            // 转义序列整体跳过（\uXXXX 的十六进制位按普通字符处理）
+            if (*pos_ == '\\' && ++pos_ == end_) {
+                return false;
+            }
+            ++pos_;
+        }
+        if (pos_ == end_) {
+            return false;
+        }
+        out = std::string_view(begin, static_cast<size_t>(pos_ - begin));
+        ++pos_;
+        return true;
+    }
+
+    bool parse_number(double& out) {
+        if (*pos_ != '-' && !std::isdigit(static_cast<unsigned char>(*pos_))) {
+            return false;
+        }
+        auto [next, ec] = std::from_chars(pos_, end_, out);
+        if (ec != std::errc()) {
+            return false;
+        }
+        pos_ = next;
+        return true;
+    }
+
+    bool parse_literal(std::string_view word) {
+        if (static_cast<size_t>(end_ - pos_) < word.size() || std::string_view(pos_, word.size()) != word) {
+            return false;
+        }
+        pos_ += word.size();
+        return true;
+    }
+
+    void skip_ws() {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r' || *pos_ == '\n')) {
+            ++pos_;
+        }
+    }
+
+    const char* pos_;                                        // 当前位置
+    const char* end_;                                        // 文本末尾
+    std::array<std::string_view, MAX_JSON_DEPTH> path_;      // 当前路径（各级键）
+    size_t depth_ = 0;                                       // 当前路径深度
+    OnLeaf& on_leaf_;                                        // 叶子回调
+};
+
+// 叶子转整数：数值截断取整，布尔为 0/1，队伍字符串按 m_iTeamNum 约定（T=2，CT=3），其余字符串尝试按整数解析
+std::optional<int> leaf_to_int(const JsonLeaf& leaf) {
+    switch (leaf.type) {
+    case JsonLeaf::Type::NUMBER:
+        if (!std::isfinite(leaf.number)) {
+            return std::nullopt;
+        }
+        return static_cast<int>(std::clamp(leaf.number, static_cast<double>(INT_MIN), static_cast<double>(INT_MAX)));
+    case JsonLeaf::Type::BOOL:
+        return leaf.boolean ? 1 : 0;
+    case JsonLeaf::Type::STRING: {
+        if (leaf.text == "T") {
+            return 2;
+        }
+        if (leaf.text == "CT") {
+            return 3;
+        }
+        int value = 0;
+        const char* end = leaf.text.data() + leaf.text.size();
+        auto [next, ec] = std::from_chars(leaf.text.data(), end, value);
+        if (ec == std::errc() && next == end) {
+            return value;
+        }
+        return std::nullopt;
+    }
+    case JsonLeaf::Type::NULL_VALUE:
+        break;
+    }
+    return std::nullopt;
+}
+
+// 忽略大小写比较（HTTP 头字段名）
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+// 去除首尾空白
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+} // namespace
+
+// ============================================
+// 单例（public）
+// ============================================
+
+GsiListener& GsiListener::instance() {
+    static GsiListener listener;
+    return listener;
+}
+
+// ============================================
+// 构造/析构（private）
+// ============================================
+
+GsiListener::GsiListener()
+    : QObject(nullptr) {
+    server_ = new QTcpServer(this);
+    connect(server_, &QTcpServer::newConnection, this, &GsiListener::on_new_connection);
+    register_default_bindings();
+}
+
+GsiListener::~GsiListener() {
+    stop();
+}
+
+// ============================================
+// 监听控制（public）
+// ============================================
+
+bool GsiListener::start(quint16 port) {
+    stop();
+    // 仅监听回环地址：GSI 由本机游戏进程推送，不对外暴露
+    if (!server_->listen(QHostAddress::LocalHost, port)) {
+        LOG_MODULE("GsiListener", "start", LOG_ERROR,
+            "GSI 监听失败（端口 " << port << "）: " << server_->errorString().toStdString());
+        return false;
+    }
+    LOG_MODULE("GsiListener", "start", LOG_INFO, "GSI 监听已启动: 127.0.0.1:" << server_->serverPort());
+    return true;
+}
+
+void GsiListener::stop() {
+    if (server_->isListening()) {
+        server_->close();
+        LOG_MODULE("GsiListener", "stop", LOG_INFO, "GSI 监听已停止");
+        // 不再有推送：被接管的数值恢复轮询
+        ModuleManager::instance().restore_polling();
+    }
+    // 断开时 disconnected 回调会修改 buffers_，先取出连接列表
+    std::vector<QTcpSocket*> sockets;
+    sockets.reserve(buffers_.size());
+    for (const auto& [socket, buffer] : buffers_) {
+        sockets.push_back(socket);
+    }
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnectFromHost();
+    }
+}
+
+bool GsiListener::is_listening() const {
+    return server_->isListening();
+}
+
+quint16 GsiListener::get_port() const {
+    return server_->isListening() ? server_->serverPort() : 0;
+}
+
+// ============================================
+// 配置（public）
+// ============================================
+
+void GsiListener::set_auth_token(const std::string& token) {
+    auth_token_ = token;
+}
+
+void GsiListener::add_binding(const std::string& path, const std::string& value_id) {
+    Binding binding;
+    binding.value_id = value_id;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t dot = path.find('.', start);
+        if (dot == std::string::npos) {
+            dot = path.size();
+        }
+        binding.path.push_back(path.substr(start, dot - start));
+        start = dot + 1;
+    }
+    bindings_.push_back(std::move(binding));
+}
+
+// ============================================
+// 解析（public）
+// ============================================
+
+bool GsiListener::ingest(std::string_view body) {
+    updates_.clear();
+    bool token_matched = auth_token_.empty();
+    auto on_leaf = [this, &token_matched](std::span<const std::string_view> path, const JsonLeaf& leaf) {
+        if (path.size() == 2 && path[0] == "auth" && path[1] == "token") {
+            token_matched = auth_token_.empty()
+                || (leaf.type == JsonLeaf::Type::STRING && leaf.text == auth_token_);
+            return;
+        }
+        // 绑定按完整路径匹配：previously/added 等子树中的旧值不会误匹配
+        for (const auto& binding : bindings_) {
+            if (!std::equal(binding.path.begin(), binding.path.end(), path.begin(), path.end())) {
+                continue;
+            }
+            if (auto value = leaf_to_int(leaf)) {
+                updates_.emplace_back(binding.value_id, *value);
+            }
+        }
+    };
+    JsonWalker walker(body, on_leaf);
+    if (!walker.walk()) {
+        LOG_MODULE("GsiListener", "ingest", LOG_WARN, "GSI 负载 JSON 格式错误，长度: " << body.size());
+        return false;
+    }
+    if (!token_matched) {
+        LOG_MODULE("GsiListener", "ingest", LOG_WARN, "GSI 鉴权令牌不匹配，已忽略负载");
+        return false;
+    }
+    if (!updates_.empty()) {
+        ModuleManager::instance().push_values(updates_, true);
+    }
+    emit payload_received(static_cast<int>(updates_.size()));
+    return true;
+}
+
+// ============================================
+// private slots 实现
+// ============================================
+
+void GsiListener::on_new_connection() {
+    while (server_->hasPendingConnections()) {
+        QTcpSocket* socket = server_->nextPendingConnection();
+        buffers_.emplace(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { on_ready_read(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            buffers_.erase(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+void GsiListener::register_default_bindings() {
+    // 参照 CS2 GSI 负载结构（需在 GSI 配置中开启 player_id、player_state）
+    add_binding("player.state.health", "health");
+    add_binding("player.state.armor", "armor");
+    add_binding("player.team", "team_num");
+    add_binding("player.state.money", "money");
+    add_binding("player.state.helmet", "has_helmet");
+    add_binding("player.state.defusekit", "has_defuser");
+}
+
+void GsiListener::on_ready_read(QTcpSocket* socket) {
+    auto it = buffers_.find(socket);
+    if (it == buffers_.end()) {
+        return;
+    }
+    it->second.append(socket->readAll());
+    // 同一次可读数据中可能包含多个完整请求
+    while (handle_request(socket, it->second)) {
+    }
+}
+
+bool GsiListener::handle_request(QTcpSocket* socket, QByteArray& buffer) {
+    int header_end = buffer.indexOf("\r\n\r\n");
+    if (header_end < 0) {
+        if (buffer.size() > MAX_REQUEST_BYTES) {
+            respond(socket, 431, "Request Header Fields Too Large", true);
+        }
+        return false;
+    }
+    std::string_view head(buffer.constData(), static_cast<size_t>(header_end));
+    size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    if (request_line.substr(0, 5) != "POST ") {
+        respond(socket, 405, "Method Not Allowed", true);
+        return false;
+    }
+
+    // 请求头：仅关心 Content-Length（GSI 不使用分块传输）
+    qint64 content_length = -1;
+    size_t pos = line_end == std::string_view::npos ? head.size() : line_end + 2;
+    while (pos < head.size()) {
+        size_t next = head.find("\r\n", pos);
+        std::string_view line = head.substr(pos, next == std::string_view::npos ? std::string_view::npos : next - pos);
+        pos = next == std::string_view::npos ? head.size() : next + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view name = trim(line.substr(0, colon));
+        std::string_view value = trim(line.substr(colon + 1));
+        if (iequals(name, "Content-Length")) {
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), content_length);
+            if (ec != std::errc() || content_length < 0) {
+                content_length = -1;
+            }
+        }
+    }
+    if (content_length < 0) {
+        respond(socket, 411, "Length Required", true);
+        return false;
+    }
+    // 先单独限制 Content-Length，避免与请求头长度相加时溢出
+    if (content_length > MAX_REQUEST_BYTES) {
+        respond(socket, 413, "Payload Too Large", true);
+        return false;
+    }
+    qint64 total = header_end + 4 + content_length;
+    if (total > MAX_REQUEST_BYTES) {
+        respond(socket, 413, "Payload Too Large", true);
+        return false;
+    }
+    if (buffer.size() < total) {
+        // 请求体尚未收全，等待后续数据
+        return false;
+    }
+
+    bool ok = ingest(std::string_view(buffer.constData() + header_end + 4, static_cast<size_t>(content_length)));
+    buffer.remove(0, total);
+    if (ok) {
+        respond(socket, 200, "OK", false);
+    }
+    else {
+        respond(socket, 400, "Bad Request", false);
+    }
+    return true;
+}
+
+void GsiListener::respond(QTcpSocket* socket, int status, const char* reason, bool close) {
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + reason
+        + "\r\nContent-Type: text/plain\r\nContent-Length: 0\r\nConnection: "
+        + (close ? "close" : "keep-alive") + "\r\n\r\n";
+    socket->write(response.data(), static_cast<qint64>(response.size()));
+    if (close) {
+        LOG_MODULE("GsiListener", "respond", LOG_WARN, "GSI 请求被拒绝: " << status << " " << reason);
+        socket->disconnectFromHost();
+    }
+}
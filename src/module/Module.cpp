@@ -25,10 +25,10 @@ int Module::get_min_period_ms() const {
     if (values_.empty()) {
         return query_period_to_ms(QueryPeriod::SECOND);
     }
-    int min_period = query_period_to_ms(values_.front().get_query_period());
+    int min_period = values_.front().get_period_ms();
     for (const auto& value : values_) {
         // 取所有数值中最短的查询周期
-        min_period = std::min(min_period, query_period_to_ms(value.get_query_period()));
+        min_period = std::min(min_period, value.get_period_ms());
     }
     return min_period;
 }
@@ -7,10 +7,29 @@
 
 #include "DebugLog.h"
 
+#include <QMetaObject>
+#include <QThread>
+
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <tuple>
 #include <utility>
 
+namespace {
+// 严格晚于 after 且满足 t ≡ phase (mod period) 的最早刻度
+uint64_t next_aligned_tick(uint64_t after, uint64_t period, uint64_t phase) {
+    uint64_t base = after + 1;
+    return base + (phase % period + period - base % period) % period;
+}
+
+// 当前 steady_clock 时刻（纳秒），用于数值更新时间戳
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
 // ============================================
 // 单例（public）
 // ============================================
@@ -26,16 +45,25 @@ ModuleManager& ModuleManager::instance() {
 
 ModuleManager::ModuleManager()
     : QObject(nullptr) {
-    // 定时器由主线程驱动，调度查询基于最短周期
+    // 定时器由主线程驱动，单次触发：每次只在时间轮最早到期时刻唤醒
+    clock_.start();
     timer_ = new QTimer(this);
     timer_->setTimerType(Qt::PreciseTimer);
+    timer_->setSingleShot(true);
     connect(timer_, &QTimer::timeout, this, &ModuleManager::on_timer_tick);
+    change_timer_ = new QTimer(this);
+    change_timer_->setTimerType(Qt::PreciseTimer);
+    change_timer_->setSingleShot(true);
+    connect(change_timer_, &QTimer::timeout, this, &ModuleManager::on_change_timer);
 }
 
 ModuleManager::~ModuleManager() {
     if (timer_) {
         timer_->stop();
     }
+    if (change_timer_) {
+        change_timer_->stop();
+    }
 }
 
 // ============================================
@@ -43,21 +71,68 @@ ModuleManager::~ModuleManager() {
 // ============================================
 
 void ModuleManager::init() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // 幂等处理：避免重复注册
-    if (!modules_.empty()) {
-        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 幂等处理：避免重复注册（init 前通过 register_module 注册的模块不影响默认模块）
+        if (initialized_) {
+            return;
+        }
+        initialized_ = true;
+        register_default_modules();
+        // 数据源由外部通过 set_data_source 提供（真实 GSI 接入前无数据，数值保持"未获取"状态）
+        if (!data_source_) {
+            LOG_MODULE("ModuleManager", "init", LOG_WARN,
+                "未设置轮询数据源，数值仅由推送更新（GsiListener/push_values），否则保持无数据状态");
+        }
+        // 默认模块的数值已加入时间轮，按最早到期时刻启动调度
+        update_base_period_locked();
+        arm_timer_locked();
+        LOG_MODULE("ModuleManager", "init", LOG_INFO,
+            "数值模块初始化完成，基准周期: " << base_period_ms_ << "ms");
     }
-    register_default_modules();
-    // 数据源由外部通过 set_data_source 提供（真实 GSI 接入前无数据，数值保持"未获取"状态）
-    if (!data_source_) {
-        LOG_MODULE("ModuleManager", "init", LOG_WARN,
-            "未设置数据源，数值模块保持无数据状态（可通过 set_data_source 接入真实数据）");
+    // 规则通常先于模块加载，注册完成后通知规则引擎重新绑定数值槽位
+    emit values_registered();
+}
+
+// ============================================
+// 模块注册（public）
+// ============================================
+
+bool ModuleManager::register_module(const Module& module) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!register_module_locked(module)) {
+            return false;
+        }
+        update_base_period_locked();
+        arm_timer_locked();
     }
-    // 以最短查询周期为基准启动调度器
-    rebuild_scheduler();
-    LOG_MODULE("ModuleManager", "init", LOG_INFO,
-        "数值模块初始化完成，基准周期: " << base_period_ms_ << "ms");
+    emit values_registered();
+    return true;
+}
+
+bool ModuleManager::add_value(const std::string& module_name, const ModuleValue& value) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int module_idx = find_module_locked(module_name);
+        if (module_idx < 0) {
+            LOG_MODULE("ModuleManager", "add_value", LOG_WARN, "未找到模块: " << module_name);
+            return false;
+        }
+        if (value_index_.count(value.get_id()) > 0) {
+            LOG_MODULE("ModuleManager", "add_value", LOG_WARN, "数值 ID 已存在: " << value.get_id());
+            return false;
+        }
+        Module& module = modules_[module_idx];
+        size_t value_idx = module.get_values().size();
+        value_index_.emplace(value.get_id(), std::make_pair(static_cast<size_t>(module_idx), value_idx));
+        module.add_value(value);
+        track_value_locked(static_cast<size_t>(module_idx), value_idx);
+        update_base_period_locked();
+        arm_timer_locked();
+    }
+    emit values_registered();
+    return true;
 }
 
 // ============================================
@@ -76,38 +151,27 @@ std::vector<std::string> ModuleManager::get_module_names() const {
 
 const Module* ModuleManager::get_module(const std::string& module_name) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& module : modules_) {
-        if (module.get_name() == module_name) {
-            return &module;
-        }
-    }
-    return nullptr;
+    int module_idx = find_module_locked(module_name);
+    return module_idx >= 0 ? &modules_[module_idx] : nullptr;
 }
 
 const ModuleValue* ModuleManager::get_value(const std::string& module_name,
     const std::string& value_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& module : modules_) {
-        if (module.get_name() != module_name) {
-            continue;
-        }
-        for (const auto& value : module.get_values()) {
-            if (value.get_id() == value_id) {
-                return &value;
-            }
-        }
-    }
-    return nullptr;
+    return find_value_locked(module_name, value_id);
 }
 
 int ModuleManager::get_module_min_period_ms(const std::string& module_name) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& module : modules_) {
-        if (module.get_name() == module_name) {
-            return module.get_min_period_ms();
-        }
-    }
-    return query_period_to_ms(QueryPeriod::SECOND);
+    int module_idx = find_module_locked(module_name);
+    return module_idx >= 0 ? modules_[module_idx].get_min_period_ms()
+                           : query_period_to_ms(QueryPeriod::SECOND);
+}
+
+int ModuleManager::get_effective_period_ms(const std::string& module_name, const std::string& value_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const ModuleValue* value = find_value_locked(module_name, value_id);
+    return value != nullptr ? value->get_effective_period_ms() : 0;
 }
 
 std::vector<std::string> ModuleManager::get_modules_for_channel(const std::string& channel) const {
@@ -123,14 +187,29 @@ std::vector<std::string> ModuleManager::get_modules_for_channel(const std::strin
 
 std::string ModuleManager::find_module_by_value_id(const std::string& value_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& module : modules_) {
-        for (const auto& value : module.get_values()) {
-            if (value.get_id() == value_id) {
-                return module.get_name();
-            }
-        }
+    auto it = value_index_.find(value_id);
+    return it != value_index_.end() ? modules_[it->second.first].get_name() : "";
+}
+
+std::shared_ptr<const ModuleValueSlot> ModuleManager::find_value_slot(
+    const std::string& value_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = value_index_.find(value_id);
+    if (it == value_index_.end()) {
+        return nullptr;
+    }
+    const auto& [module_idx, value_idx] = it->second;
+    return modules_[module_idx].get_values()[value_idx].get_slot();
+}
+
+std::shared_ptr<const ValueHistory> ModuleManager::find_value_history(const std::string& value_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = value_index_.find(value_id);
+    if (it == value_index_.end()) {
+        return nullptr;
     }
-    return "";
+    const auto& [module_idx, value_idx] = it->second;
+    return modules_[module_idx].get_values()[value_idx].get_history();
 }
 
 // ============================================
@@ -139,49 +218,60 @@ std::string ModuleManager::find_module_by_value_id(const std::string& value_id)
 
 void ModuleManager::set_value_period(const std::string& module_name, const std::string& value_id,
     QueryPeriod period) {
+    set_value_period_ms(module_name, value_id, query_period_to_ms(period));
+}
+
+void ModuleManager::set_value_period_ms(const std::string& module_name, const std::string& value_id,
+    int period_ms) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        bool found = false;
-        for (auto& module : modules_) {
-            if (module.get_name() != module_name) {
-                continue;
-            }
-            for (auto& value : module.get_values()) {
-                if (value.get_id() == value_id) {
-                    value.set_query_period(period);
-                    found = true;
-                    break;
-                }
-            }
-            break;
-        }
-        if (!found) {
-            LOG_MODULE("ModuleManager", "set_value_period", LOG_WARN,
+        auto index = find_value_index_locked(module_name, value_id);
+        if (!index) {
+            LOG_MODULE("ModuleManager", "set_value_period_ms", LOG_WARN,
                 "未找到数值: " << module_name << "/" << value_id);
             return;
         }
-        rebuild_scheduler();
+        const auto& [module_idx, value_idx] = *index;
+        modules_[module_idx].get_values()[value_idx].set_period_ms(period_ms);
+        // 仅重新调度该数值，其余数值保持原有到期时刻与相位
+        schedule_value_locked(module_idx, value_idx);
+        update_base_period_locked();
+        arm_timer_locked();
     }
     emit period_changed();
 }
 
+void ModuleManager::set_value_phase_ms(const std::string& module_name, const std::string& value_id,
+    int phase_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index = find_value_index_locked(module_name, value_id);
+    if (!index) {
+        LOG_MODULE("ModuleManager", "set_value_phase_ms", LOG_WARN,
+            "未找到数值: " << module_name << "/" << value_id);
+        return;
+    }
+    const auto& [module_idx, value_idx] = *index;
+    modules_[module_idx].get_values()[value_idx].set_phase_ms(phase_ms);
+    schedule_value_locked(module_idx, value_idx);
+    arm_timer_locked();
+}
+
 void ModuleManager::set_module_period(const std::string& module_name, QueryPeriod period) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        bool found = false;
-        for (auto& module : modules_) {
-            if (module.get_name() == module_name) {
-                module.set_all_values_period(period);
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
+        int module_idx = find_module_locked(module_name);
+        if (module_idx < 0) {
             LOG_MODULE("ModuleManager", "set_module_period", LOG_WARN,
                 "未找到模块: " << module_name);
             return;
         }
-        rebuild_scheduler();
+        Module& module = modules_[module_idx];
+        module.set_all_values_period(period);
+        for (size_t value_idx = 0; value_idx < module.get_values().size(); ++value_idx) {
+            schedule_value_locked(static_cast<size_t>(module_idx), value_idx);
+        }
+        update_base_period_locked();
+        arm_timer_locked();
     }
     emit period_changed();
 }
@@ -189,23 +279,159 @@ void ModuleManager::set_module_period(const std::string& module_name, QueryPerio
 void ModuleManager::set_all_period(QueryPeriod period) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (auto& module : modules_) {
+        for (size_t module_idx = 0; module_idx < modules_.size(); ++module_idx) {
+            Module& module = modules_[module_idx];
             module.set_all_values_period(period);
+            for (size_t value_idx = 0; value_idx < module.get_values().size(); ++value_idx) {
+                schedule_value_locked(module_idx, value_idx);
+            }
         }
-        rebuild_scheduler();
+        update_base_period_locked();
+        arm_timer_locked();
     }
     emit period_changed();
     LOG_MODULE("ModuleManager", "set_all_period", LOG_INFO,
         "已统一设置所有数值查询周期: " << query_period_to_text(period));
 }
 
+// ============================================
+// 自适应轮询（public）
+// ============================================
+
+void ModuleManager::set_adaptive_polling(bool enabled, int idle_polls, int max_period_ms) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        adaptive_polling_ = enabled;
+        adaptive_idle_polls_ = std::max(idle_polls, 1);
+        adaptive_max_period_ms_ = std::max(max_period_ms, ModuleValue::MIN_PERIOD_MS);
+        // 关闭或调整参数时统一恢复查询周期，之后按新参数重新累计
+        for (size_t module_idx = 0; module_idx < modules_.size(); ++module_idx) {
+            auto& values = modules_[module_idx].get_values();
+            for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+                ModuleValue& value = values[value_idx];
+                value.set_unchanged_polls(0);
+                if (value.get_effective_period_ms() != value.get_period_ms()) {
+                    value.set_backoff_period_ms(0);
+                    schedule_value_locked(module_idx, value_idx);
+                }
+            }
+        }
+        arm_timer_locked();
+    }
+    emit period_changed();
+    LOG_MODULE("ModuleManager", "set_adaptive_polling", LOG_INFO,
+        "自适应轮询: " << (enabled ? "启用" : "关闭") << "，连续 " << idle_polls << " 次未变化退避，上限 "
+        << max_period_ms << "ms");
+}
+
+bool ModuleManager::is_adaptive_polling() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return adaptive_polling_;
+}
+
+void ModuleManager::reset_adaptive_periods(const std::vector<std::string>& value_ids) {
+    std::vector<std::tuple<std::string, std::string, int>> restored;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& value_id : value_ids) {
+            auto it = value_index_.find(value_id);
+            if (it == value_index_.end()) {
+                continue;
+            }
+            const auto& [module_idx, value_idx] = it->second;
+            if (adapt_period_locked(module_idx, value_idx, false)) {
+                const ModuleValue& value = modules_[module_idx].get_values()[value_idx];
+                restored.emplace_back(modules_[module_idx].get_name(), value_id, value.get_effective_period_ms());
+            }
+        }
+        if (!restored.empty()) {
+            arm_timer_locked();
+        }
+    }
+    for (const auto& [module_name, value_id, period_ms] : restored) {
+        emit effective_period_changed(QString::fromStdString(module_name), QString::fromStdString(value_id), period_ms);
+    }
+}
+
+// ============================================
+// 变化判定（public）
+// ============================================
+
+void ModuleManager::set_value_change_policy(const std::string& module_name, const std::string& value_id,
+    const ChangePolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ModuleValue* value = find_value_locked(module_name, value_id);
+    if (value == nullptr) {
+        LOG_MODULE("ModuleManager", "set_value_change_policy", LOG_WARN,
+            "未找到数值: " << module_name << "/" << value_id);
+        return;
+    }
+    value->set_change_policy(policy);
+    LOG_MODULE("ModuleManager", "set_value_change_policy", LOG_DEBUG,
+        "数值 " << value_id << " 变化判定: 死区 " << policy.deadband << "，相对死区 " << policy.deadband_ratio
+        << "，回滞 " << policy.hysteresis << "，最小间隔 " << policy.min_interval_ms << "ms");
+}
+
+// ============================================
+// 历史设置（public）
+// ============================================
+
+void ModuleManager::set_history_options(size_t memory_budget, int window_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    history_budget_ = memory_budget;
+    history_window_ms_ = window_ms;
+    // 已取得旧历史的读取方仍持有旧对象（保持有效，不再更新），需重新获取
+    for (auto& module : modules_) {
+        for (auto& value : module.get_values()) {
+            value.reset_history(memory_budget, window_ms);
+        }
+    }
+    LOG_MODULE("ModuleManager", "set_history_options", LOG_INFO,
+        "数值历史: 预算 " << memory_budget << " 字节/数值，统计窗口 " << window_ms << "ms");
+}
+
+// ============================================
+// 轨迹录制（public）
+// ============================================
+
+bool ModuleManager::start_trace_recording(const QString& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trace_writer_.open(path);
+}
+
+void ModuleManager::stop_trace_recording() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trace_writer_.close();
+}
+
+bool ModuleManager::is_trace_recording() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trace_writer_.is_open();
+}
+
 // ============================================
 // 数据源（public）
 // ============================================
 
 void ModuleManager::set_data_source(DataSource source) {
+    if (!source) {
+        set_batch_data_source(nullptr);
+        return;
+    }
+    // 逐值数据源包装为批量接口：逐个调用，始终就绪
+    set_batch_data_source([source = std::move(source)](const std::vector<std::string>& value_ids,
+        std::span<std::optional<int>> out) {
+        for (size_t i = 0; i < value_ids.size(); ++i) {
+            out[i] = source(value_ids[i]);
+        }
+        return FetchStatus::READY;
+    });
+}
+
+void ModuleManager::set_batch_data_source(BatchDataSource source) {
+    auto shared = source ? std::make_shared<const BatchDataSource>(std::move(source)) : nullptr;
     std::lock_guard<std::mutex> lock(mutex_);
-    data_source_ = std::move(source);
+    data_source_ = std::move(shared);
 }
 
 // ============================================
@@ -213,37 +439,108 @@ void ModuleManager::set_data_source(DataSource source) {
 // ============================================
 
 int ModuleManager::query_value(const std::string& module_name, const std::string& value_id) {
-    int new_value = 0;
-    bool changed = false;
+    std::shared_ptr<const BatchDataSource> source;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (auto& module : modules_) {
-            if (module.get_name() != module_name) {
-                continue;
-            }
-            for (auto& value : module.get_values()) {
-                if (value.get_id() == value_id) {
-                    if (!data_source_) {
-                        // 无数据源：保持"未获取"状态，不更新数值
-                        break;
-                    }
-                    new_value = data_source_(value_id);
-                    // 数值变化检测：已有历史值且与最新值不同才推送
-                    changed = value.get_has_value() && value.get_last_value() != new_value;
-                    value.set_last_value(new_value);
-                    break;
-                }
-            }
-            break;
+        if (find_value_locked(module_name, value_id) == nullptr) {
+            return 0;
         }
+        source = data_source_;
+    }
+    // 无数据源、未就绪或无该数值数据：保持"未获取"状态，不更新数值
+    std::optional<int> fetched;
+    if (!source || (*source)({ value_id }, std::span<std::optional<int>>(&fetched, 1)) != FetchStatus::READY
+        || !fetched) {
+        return 0;
+    }
+    int new_value = *fetched;
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ModuleValue* value = find_value_locked(module_name, value_id);
+        changed = value != nullptr && apply_value_locked(*value, new_value, steady_now_ns());
     }
     if (changed) {
         emit value_changed(QString::fromStdString(module_name),
             QString::fromStdString(value_id), new_value);
+        emit values_changed(QStringList{ QString::fromStdString(value_id) });
     }
     return new_value;
 }
 
+void ModuleManager::publish(const std::string& value_id, int value) {
+    publish_queue_.push(PublishedValue{ value_id, NO_VALUE_KEY, value, steady_now_ns() });
+    // 至多投递一次消费：消费开始时清除标志，其后的发布会重新投递
+    if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() { drain_published(); }, Qt::QueuedConnection);
+    }
+}
+
+void ModuleManager::publish_by_key(uint32_t value_key, int value) {
+    publish_queue_.push(PublishedValue{ {}, value_key, value, steady_now_ns() });
+    if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() { drain_published(); }, Qt::QueuedConnection);
+    }
+}
+
+std::optional<uint32_t> ModuleManager::find_value_key(std::string_view value_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = value_index_.find(std::string(value_id));
+    if (it == value_index_.end()) {
+        return std::nullopt;
+    }
+    const auto& [module_idx, value_idx] = it->second;
+    return value_keys_[module_idx][value_idx];
+}
+
+void ModuleManager::push_values(const std::vector<std::pair<std::string, int>>& values, bool take_over,
+    int64_t timestamp_ns) {
+    if (timestamp_ns == 0) {
+        timestamp_ns = steady_now_ns();
+    }
+    for (const auto& [value_id, value] : values) {
+        publish_queue_.push(PublishedValue{ value_id, NO_VALUE_KEY, value, timestamp_ns, take_over });
+    }
+    if (QThread::currentThread() == thread()) {
+        // 已在消费线程（如 GsiListener）：立即消费，省去一轮事件循环
+        drain_published();
+    }
+    else if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() { drain_published(); }, Qt::QueuedConnection);
+    }
+}
+
+void ModuleManager::restore_polling() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t restored = 0;
+    for (size_t module_idx = 0; module_idx < modules_.size(); ++module_idx) {
+        auto& values = modules_[module_idx].get_values();
+        for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+            if (values[value_idx].get_push_driven()) {
+                values[value_idx].set_push_driven(false);
+                schedule_value_locked(module_idx, value_idx);
+                ++restored;
+            }
+        }
+    }
+    if (restored > 0) {
+        arm_timer_locked();
+        LOG_MODULE("ModuleManager", "restore_polling", LOG_INFO, restored << " 个推送驱动的数值已恢复轮询");
+    }
+}
+
+void ModuleManager::reset_value_states() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now_ns = steady_now_ns();
+    for (auto& module : modules_) {
+        for (auto& value : module.get_values()) {
+            value.reset_history(history_budget_, history_window_ms_);
+            value.get_change_state() = value.get_has_value()
+                ? ChangeState{ value.get_last_value(), now_ns, 0, false } : ChangeState{};
+        }
+    }
+}
+
 int ModuleManager::get_base_period_ms() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return base_period_ms_;
@@ -254,63 +551,280 @@ int ModuleManager::get_base_period_ms() const {
 // ============================================
 
 void ModuleManager::on_timer_tick() {
-    ++tick_count_;
-    // 收集本周期内发生变化的数值（先查后发，避免持锁发信号）
+    // 第一步（持锁）：推进时间轮，收集到期数值并重新调度
+    std::shared_ptr<const BatchDataSource> source;
+    due_keys_.clear();
+    due_ids_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t now = static_cast<uint64_t>(clock_.elapsed());
+        expired_.clear();
+        wheel_.advance(now, expired_);
+        for (const auto& timer : expired_) {
+            const auto& [module_idx, value_idx] = schedule_keys_[timer.key];
+            const ModuleValue& value = modules_[module_idx].get_values()[value_idx];
+            due_keys_.push_back(timer.key);
+            due_ids_.push_back(value.get_id());
+            // 以到期刻度而非唤醒时刻推算下一次到期，相位不随唤醒延迟漂移；落后超过一个周期时跳过错过的周期
+            uint64_t period = static_cast<uint64_t>(value.get_effective_period_ms());
+            uint64_t next = timer.due_tick + period;
+            if (next <= now) {
+                next = next_aligned_tick(now, period, timer.due_tick);
+            }
+            wheel_.schedule(timer.key, next);
+        }
+        arm_timer_locked();
+        source = data_source_;
+    }
+    if (due_keys_.empty() || !source) {
+        // 无数据源：保持"未获取"状态，不产生变化
+        return;
+    }
+
+    // 第二步（不持锁）：一次调用批量拉取全部到期数值，慢数据源不再阻塞规则引擎等对模块数据的访问
+    fetched_.assign(due_keys_.size(), std::nullopt);
+    if ((*source)(due_ids_, std::span<std::optional<int>>(fetched_)) != FetchStatus::READY) {
+        return;
+    }
+    int64_t fetched_ns = steady_now_ns();
+
+    // 第三步（持锁）：写入结果并检测变化（先查后发，避免持锁发信号）
+    std::vector<std::tuple<std::string, std::string, int>> changes;
+    std::vector<std::tuple<std::string, std::string, int>> adapted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < due_keys_.size(); ++i) {
+            if (!fetched_[i]) {
+                continue;
+            }
+            const auto& [module_idx, value_idx] = schedule_keys_[due_keys_[i]];
+            Module& module = modules_[module_idx];
+            ModuleValue& value = module.get_values()[value_idx];
+            // 自适应轮询按原始数值是否相同计数（不受变化判定策略影响）
+            bool unchanged = value.get_has_value() && value.get_last_value() == *fetched_[i];
+            if (apply_value_locked(value, *fetched_[i], fetched_ns)) {
+                changes.emplace_back(module.get_name(), value.get_id(), *fetched_[i]);
+            }
+            if (adaptive_polling_ && adapt_period_locked(module_idx, value_idx, unchanged)) {
+                adapted.emplace_back(module.get_name(), value.get_id(), value.get_effective_period_ms());
+            }
+        }
+        if (!adapted.empty()) {
+            arm_timer_locked();
+        }
+    }
+    emit_changes(changes);
+    for (const auto& [module_name, value_id, period_ms] : adapted) {
+        emit effective_period_changed(QString::fromStdString(module_name), QString::fromStdString(value_id), period_ms);
+    }
+}
+
+void ModuleManager::on_change_timer() {
     std::vector<std::tuple<std::string, std::string, int>> changes;
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        change_due_ns_ = 0;
+        int64_t now_ns = steady_now_ns();
+        // 延后的变化很少，逐个检查即可；间隔未满的会在 evaluate_change_locked 中重新设置定时器
         for (auto& module : modules_) {
             for (auto& value : module.get_values()) {
-                int period_ms = query_period_to_ms(value.get_query_period());
-                int interval = period_ms / base_period_ms_;
-                if (interval < 1) {
-                    interval = 1;
+                if (value.get_change_state().pending && evaluate_change_locked(value, now_ns)) {
+                    changes.emplace_back(module.get_name(), value.get_id(), value.get_last_value());
                 }
-                // 按基准周期取模：周期越短的数值被查询的次数越多
-                if (tick_count_ % interval != 0) {
+            }
+        }
+    }
+    emit_changes(changes);
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+void ModuleManager::drain_published() {
+    drain_scheduled_.store(false, std::memory_order_release);
+    std::vector<std::tuple<std::string, std::string, int>> changes;
+    int64_t max_latency_ns = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t now_ns = steady_now_ns();
+        while (auto item = publish_queue_.try_pop()) {
+            std::pair<size_t, size_t> index;
+            if (item->value_key != NO_VALUE_KEY) {
+                if (item->value_key >= schedule_keys_.size()) {
                     continue;
                 }
-                if (query_value_locked(module, value)) {
-                    changes.emplace_back(module.get_name(), value.get_id(),
-                        value.get_last_value());
+                index = schedule_keys_[item->value_key];
+            }
+            else {
+                auto it = value_index_.find(item->value_id);
+                if (it == value_index_.end()) {
+                    continue;
                 }
+                index = it->second;
+            }
+            const auto& [module_idx, value_idx] = index;
+            Module& module = modules_[module_idx];
+            ModuleValue& value = module.get_values()[value_idx];
+            if (item->take_over && !value.get_push_driven()) {
+                // 转为推送驱动：取消周期调度，该数值此后只由推送更新（推送源停止时经 restore_polling 恢复）
+                value.set_push_driven(true);
+                wheel_.cancel(value_keys_[module_idx][value_idx]);
+                LOG_MODULE("ModuleManager", "drain_published", LOG_DEBUG,
+                    "数值 " << value.get_id() << " 转为推送驱动，已停止轮询");
+            }
+            max_latency_ns = std::max(max_latency_ns, now_ns - item->timestamp_ns);
+            if (apply_value_locked(value, item->value, item->timestamp_ns)) {
+                changes.emplace_back(module.get_name(), value.get_id(), item->value);
             }
         }
     }
-    // 数值变化时推送（触发规则计算与界面刷新）
+    if (max_latency_ns > PUBLISH_LATENCY_BUDGET_NS) {
+        LOG_MODULE("ModuleManager", "drain_published", LOG_DEBUG,
+            "发布到消费延迟 " << max_latency_ns / 1000 << "us，超过 " << PUBLISH_LATENCY_BUDGET_NS / 1000 << "us");
+    }
+    emit_changes(changes);
+}
+
+void ModuleManager::emit_changes(const std::vector<std::tuple<std::string, std::string, int>>& changes) {
+    if (changes.empty()) {
+        return;
+    }
+    // 数值变化时逐个推送（界面刷新），再整批推送一次（规则引擎按批次合并计算）
+    QStringList changed_ids;
+    changed_ids.reserve(static_cast<int>(changes.size()));
     for (const auto& [module_name, value_id, new_value] : changes) {
         emit value_changed(QString::fromStdString(module_name),
             QString::fromStdString(value_id), new_value);
+        changed_ids.append(QString::fromStdString(value_id));
     }
+    emit values_changed(changed_ids);
 }
 
-// ============================================
-// 私有辅助函数实现（private）
-// ============================================
+void ModuleManager::track_value_locked(size_t module_idx, size_t value_idx) {
+    if (history_budget_ != ValueHistory::DEFAULT_MEMORY_BUDGET
+        || history_window_ms_ != ValueHistory::DEFAULT_WINDOW_MS) {
+        modules_[module_idx].get_values()[value_idx].reset_history(history_budget_, history_window_ms_);
+    }
+    uint32_t key = static_cast<uint32_t>(schedule_keys_.size());
+    schedule_keys_.emplace_back(module_idx, value_idx);
+    if (value_keys_.size() <= module_idx) {
+        value_keys_.resize(module_idx + 1);
+    }
+    value_keys_[module_idx].push_back(key);
+    schedule_value_locked(module_idx, value_idx);
+}
+
+void ModuleManager::schedule_value_locked(size_t module_idx, size_t value_idx) {
+    const ModuleValue& value = modules_[module_idx].get_values()[value_idx];
+    if (value.get_push_driven()) {
+        // 推送驱动的数值不参与周期调度
+        wheel_.cancel(value_keys_[module_idx][value_idx]);
+        return;
+    }
+    uint64_t period = static_cast<uint64_t>(value.get_effective_period_ms());
+    uint64_t phase = static_cast<uint64_t>(value.get_phase_ms());
+    uint64_t now = std::max(static_cast<uint64_t>(clock_.elapsed()), wheel_.now_tick());
+    // 重新调度会使该键在时间轮中的旧条目惰性失效
+    wheel_.schedule(value_keys_[module_idx][value_idx], next_aligned_tick(now, period, phase));
+}
+
+bool ModuleManager::adapt_period_locked(size_t module_idx, size_t value_idx, bool unchanged) {
+    ModuleValue& value = modules_[module_idx].get_values()[value_idx];
+    int before = value.get_effective_period_ms();
+    if (!unchanged) {
+        // 数值变化：立即恢复查询周期（已按退避周期排定的下一次到期作废）
+        value.set_unchanged_polls(0);
+        value.set_backoff_period_ms(0);
+        if (value.get_effective_period_ms() == before) {
+            return false;
+        }
+        schedule_value_locked(module_idx, value_idx);
+        return true;
+    }
+    int polls = value.get_unchanged_polls() + 1;
+    if (polls < adaptive_idle_polls_) {
+        value.set_unchanged_polls(polls);
+        return false;
+    }
+    // 连续未变化：周期翻倍（不超过上限），下一次到期起按新周期调度
+    value.set_unchanged_polls(0);
+    value.set_backoff_period_ms(static_cast<int>(std::min<int64_t>(static_cast<int64_t>(before) * 2,
+        std::max(adaptive_max_period_ms_, value.get_period_ms()))));
+    return value.get_effective_period_ms() != before;
+}
+
+void ModuleManager::arm_timer_locked() {
+    if (!timer_) {
+        return;
+    }
+    std::optional<uint64_t> next = wheel_.next_due_tick();
+    if (!next) {
+        timer_->stop();
+        return;
+    }
+    uint64_t now = static_cast<uint64_t>(clock_.elapsed());
+    uint64_t delay = *next > now ? *next - now : 0;
+    timer_->start(static_cast<int>(std::min<uint64_t>(delay, INT_MAX)));
+}
 
-void ModuleManager::rebuild_scheduler() {
+void ModuleManager::update_base_period_locked() {
     base_period_ms_ = query_period_to_ms(QueryPeriod::SECOND);
     for (const auto& module : modules_) {
         base_period_ms_ = std::min(base_period_ms_, module.get_min_period_ms());
     }
-    tick_count_ = 0;
-    if (timer_) {
-        timer_->start(base_period_ms_);
+    LOG_MODULE("ModuleManager", "update_base_period_locked", LOG_DEBUG,
+        "调度基准周期: " << base_period_ms_ << "ms");
+}
+
+bool ModuleManager::apply_value_locked(ModuleValue& value, int new_value, int64_t timestamp_ns) {
+    value.set_last_update_ns(timestamp_ns);
+    value.record_history(timestamp_ns, new_value);
+    if (trace_writer_.is_open()) {
+        trace_writer_.append(timestamp_ns, value.get_id(), new_value);
     }
-    LOG_MODULE("ModuleManager", "rebuild_scheduler", LOG_DEBUG,
-        "调度器已重建，基准周期: " << base_period_ms_ << "ms");
+    // 槽位始终保存最新数值（规则读取不滞后），是否推送变化由变化判定策略决定
+    bool had_value = value.get_has_value();
+    value.set_last_value(new_value);
+    if (!had_value) {
+        // 首次获取：作为基准值，不算变化
+        value.get_change_state() = ChangeState{ new_value, timestamp_ns, 0, false };
+        return false;
+    }
+    return evaluate_change_locked(value, timestamp_ns);
 }
 
-bool ModuleManager::query_value_locked(Module& module, ModuleValue& value) {
-    if (!data_source_) {
-        // 无数据源：保持"未获取"状态，不产生变化
+bool ModuleManager::evaluate_change_locked(ModuleValue& value, int64_t now_ns) {
+    const ChangePolicy& policy = value.get_change_policy();
+    ChangeState& state = value.get_change_state();
+    int current = value.get_last_value();
+    if (!policy.exceeds(state.reference_value, current, state.direction)) {
+        // 回到死区内：先前延后的变化一并撤销
+        state.pending = false;
         return false;
     }
-    int new_value = data_source_(value.get_id());
-    // 数值变化检测：已有历史值且与最新值不同才返回 true（触发推送）
-    bool changed = value.get_has_value() && value.get_last_value() != new_value;
-    value.set_last_value(new_value);
-    return changed;
+    int64_t ready_ns = state.reference_ns + static_cast<int64_t>(policy.min_interval_ms) * 1'000'000;
+    if (now_ns < ready_ns) {
+        // 间隔未满：延后到间隔结束时推送届时的最新数值，避免最后一次变化丢失
+        state.pending = true;
+        arm_change_timer_locked(ready_ns);
+        return false;
+    }
+    state.direction = current > state.reference_value ? 1 : -1;
+    state.reference_value = current;
+    state.reference_ns = now_ns;
+    state.pending = false;
+    return true;
+}
+
+void ModuleManager::arm_change_timer_locked(int64_t ready_ns) {
+    if (!change_timer_ || (change_due_ns_ != 0 && change_due_ns_ <= ready_ns)) {
+        return;
+    }
+    change_due_ns_ = ready_ns;
+    // 向上取整到毫秒，保证触发时间隔已满
+    int64_t delay_ms = std::max<int64_t>((ready_ns - steady_now_ns() + 999'999) / 1'000'000, 0);
+    change_timer_->start(static_cast<int>(std::min<int64_t>(delay_ms, INT_MAX)));
 }
 
 void ModuleManager::register_default_modules() {
@@ -323,8 +837,65 @@ void ModuleManager::register_default_modules() {
     cs2_module.add_value(ModuleValue("money", "金钱", QueryPeriod::TWO_SECONDS, "m_iMoney"));
     cs2_module.add_value(ModuleValue("has_helmet", "是否有头盔", QueryPeriod::FOUR_SECONDS, "m_bHasHelmet"));
     cs2_module.add_value(ModuleValue("has_defuser", "是否有拆弹器", QueryPeriod::FOUR_SECONDS, "m_bHasDefuser"));
-    modules_.push_back(cs2_module);
+    register_module_locked(cs2_module);
     LOG_MODULE("ModuleManager", "register_default_modules", LOG_DEBUG,
         "已注册默认模块: " << cs2_module.get_name() << "，数值数量: " << cs2_module.get_values().size());
 }
 
+
+bool ModuleManager::register_module_locked(const Module& module) {
+    if (module_index_.count(module.get_name()) > 0) {
+        LOG_MODULE("ModuleManager", "register_module_locked", LOG_WARN, "模块已存在: " << module.get_name());
+        return false;
+    }
+    // 数值 ID 全局唯一（规则以 {id:xxx} 引用，不带模块名）
+    const auto& values = module.get_values();
+    for (size_t i = 0; i < values.size(); ++i) {
+        bool duplicated = value_index_.count(values[i].get_id()) > 0;
+        for (size_t j = 0; !duplicated && j < i; ++j) {
+            duplicated = values[j].get_id() == values[i].get_id();
+        }
+        if (duplicated) {
+            LOG_MODULE("ModuleManager", "register_module_locked", LOG_WARN,
+                "模块 " << module.get_name() << " 的数值 ID 重复: " << values[i].get_id());
+            return false;
+        }
+    }
+    size_t module_idx = modules_.size();
+    modules_.push_back(module);
+    module_index_.emplace(module.get_name(), module_idx);
+    for (size_t i = 0; i < values.size(); ++i) {
+        value_index_.emplace(values[i].get_id(), std::make_pair(module_idx, i));
+        track_value_locked(module_idx, i);
+    }
+    return true;
+}
+
+int ModuleManager::find_module_locked(const std::string& module_name) const {
+    auto it = module_index_.find(module_name);
+    return it != module_index_.end() ? static_cast<int>(it->second) : -1;
+}
+
+ModuleValue* ModuleManager::find_value_locked(const std::string& module_name, const std::string& value_id) {
+    const auto* self = this;
+    return const_cast<ModuleValue*>(self->find_value_locked(module_name, value_id));
+}
+
+const ModuleValue* ModuleManager::find_value_locked(const std::string& module_name,
+    const std::string& value_id) const {
+    auto index = find_value_index_locked(module_name, value_id);
+    return index ? &modules_[index->first].get_values()[index->second] : nullptr;
+}
+
+std::optional<std::pair<size_t, size_t>> ModuleManager::find_value_index_locked(
+    const std::string& module_name, const std::string& value_id) const {
+    auto it = value_index_.find(value_id);
+    if (it == value_index_.end()) {
+        return std::nullopt;
+    }
+    // 数值须属于指定模块
+    if (modules_[it->second.first].get_name() != module_name) {
+        return std::nullopt;
+    }
+    return it->second;
+}
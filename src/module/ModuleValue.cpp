@@ -9,10 +9,25 @@
 // 构造/析构（public）
 // ============================================
 
+ModuleValue::ModuleValue()
+    : slot_(std::make_shared<ModuleValueSlot>())
+    , history_(std::make_shared<ValueHistory>()) {
+}
+
 ModuleValue::ModuleValue(const std::string& id, const std::string& name, QueryPeriod period,
     const std::string& field)
     : id_(id)
     , name_(name)
-    , query_period_(period)
-    , field_(field) {
+    , period_ms_(query_period_to_ms(period))
+    , field_(field)
+    , slot_(std::make_shared<ModuleValueSlot>())
+    , history_(std::make_shared<ValueHistory>()) {
+}
+
+// ============================================
+// 公共接口（public）
+// ============================================
+
+void ModuleValue::reset_history(size_t memory_budget, int window_ms) {
+    history_ = std::make_shared<ValueHistory>(memory_budget, window_ms);
 }
@@ -52,6 +52,8 @@ ModuleValuesDialog::ModuleValuesDialog(const std::string& module_name, QWidget*
         this, &ModuleValuesDialog::on_value_changed);
     connect(&manager, &ModuleManager::period_changed,
         this, &ModuleValuesDialog::on_period_changed);
+    connect(&manager, &ModuleManager::effective_period_changed,
+        this, &ModuleValuesDialog::on_effective_period_changed);
 
     LOG_MODULE("ModuleValuesDialog", "ModuleValuesDialog", LOG_DEBUG,
         "模块数值对话框构建完成");
@@ -101,10 +103,24 @@ void ModuleValuesDialog::on_period_changed() {
                 value_boxes_[i].period_combo->setCurrentIndex(idx);
             }
         }
+        update_effective_label(i, manager.get_effective_period_ms(module_name_, value_ids_[i]));
     }
     syncing_combos_ = false;
 }
 
+void ModuleValuesDialog::on_effective_period_changed(const QString& module_name, const QString& value_id,
+    int effective_period_ms) {
+    if (module_name != QString::fromStdString(module_name_)) {
+        return;
+    }
+    for (size_t i = 0; i < value_ids_.size(); ++i) {
+        if (value_ids_[i] == value_id.toStdString()) {
+            update_effective_label(i, effective_period_ms);
+            return;
+        }
+    }
+}
+
 // ============================================
 // 私有辅助函数实现（private）
 // ============================================
@@ -201,8 +217,13 @@ void ModuleValuesDialog::create_value_box(const ModuleValue& value, QGridLayout*
         period_combo->setCurrentIndex(current_index);
     }
     period_combo->setProperty("type", "module_period_combo");
+    // 自适应轮询退避后的实际周期（与查询周期相同时隐藏）
+    QLabel* effective_label = new QLabel(box);
+    effective_label->setProperty("type", "module_value_field");
+    effective_label->setVisible(false);
     period_row->addWidget(period_label);
     period_row->addWidget(period_combo, 1);
+    period_row->addWidget(effective_label);
     box_layout->addLayout(period_row);
 
     ValueBox vb;
@@ -210,6 +231,7 @@ void ModuleValuesDialog::create_value_box(const ModuleValue& value, QGridLayout*
     vb.value_label = value_label;
     vb.field_label = field_label;
     vb.period_combo = period_combo;
+    vb.effective_label = effective_label;
     value_boxes_.push_back(vb);
 
     // 下拉框变化时应用新的查询周期（捕获数值框索引，避免多个下拉框共用参数歧义）
@@ -222,6 +244,14 @@ void ModuleValuesDialog::create_value_box(const ModuleValue& value, QGridLayout*
     layout->addWidget(box, row, col);
 }
 
+void ModuleValuesDialog::update_effective_label(size_t box_index, int effective_period_ms) {
+    const ModuleValue* value = ModuleManager::instance().get_value(module_name_, value_ids_[box_index]);
+    QLabel* label = value_boxes_[box_index].effective_label;
+    bool backed_off = value != nullptr && effective_period_ms > value->get_period_ms();
+    label->setText(backed_off ? QString("实际 %1ms").arg(effective_period_ms) : QString());
+    label->setVisible(backed_off);
+}
+
 void ModuleValuesDialog::refresh_all_boxes() {
     on_period_changed();
     auto& manager = ModuleManager::instance();
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "ShmRingSource.h"
+
+#include "DebugLog.h"
+#include "ModuleManager.h"
+#include "dglab_shm_ring.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+// ============================================
+// 单例（public）
+// ============================================
+
+ShmRingSource& ShmRingSource::instance() {
+    static ShmRingSource instance;
+    return instance;
+}
+
+// ============================================
+// 构造/析构（private）
+// ============================================
+
+ShmRingSource::ShmRingSource() {
+    // 新注册的模块可能包含先前未知的数值 ID，通知消费线程重新解析
+    QObject::connect(&ModuleManager::instance(), &ModuleManager::values_registered,
+        [this]() { keys_stale_.store(true, std::memory_order_release); });
+}
+
+ShmRingSource::~ShmRingSource() {
+    stop();
+}
+
+// ============================================
+// 公共接口（public）
+// ============================================
+
+bool ShmRingSource::start(const std::string& name, uint32_t capacity) {
+    stop();
+    name_ = name;
+    capacity = std::bit_ceil(std::max<uint32_t>(capacity, 16));
+    if (!map_segment(dglab_shm_ring_bytes(capacity))) {
+        return false;
+    }
+    std::memset(ring_, 0, sizeof(dglab_shm_ring));
+    ring_->version = DGLAB_SHM_RING_VERSION;
+    ring_->capacity = capacity;
+    ring_->record_size = sizeof(dglab_shm_record);
+    // 魔数最后写入：生产者看到魔数时环头其余字段已就绪
+    DGLAB_SHM_STORE_RELEASE32(&ring_->magic, DGLAB_SHM_RING_MAGIC);
+
+    keys_.clear();
+    reported_dropped_ = 0;
+    consumed_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this]() { run(); });
+    LOG_MODULE("ShmRingSource", "start", LOG_INFO,
+        "共享内存数据源已启动: " << name_ << "（" << capacity << " 条记录，" << bytes_ << " 字节）");
+    return true;
+}
+
+void ShmRingSource::stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (ring_ != nullptr) {
+        unmap_segment();
+        LOG_MODULE("ShmRingSource", "stop", LOG_INFO,
+            "共享内存数据源已停止: " << name_ << "，共消费 " << consumed_.load(std::memory_order_relaxed) << " 条记录");
+        // 不再有推送：被接管的数值恢复轮询
+        ModuleManager::instance().restore_polling();
+    }
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+bool ShmRingSource::map_segment(size_t bytes) {
+    char native[256];
+    dglab_shm_ring_native_name(name_.c_str(), native, sizeof(native));
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(bytes) >> 32), static_cast<DWORD>(bytes), native);
+    void* base = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (base == nullptr) {
+        LOG_MODULE("ShmRingSource", "map_segment", LOG_ERROR,
+            "创建共享内存段失败: " << native << "（错误码 " << GetLastError() << "）");
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    // 清理上次异常退出遗留的同名段，生产者须在客户端启动后重新打开
+    shm_unlink(native);
+    int fd = shm_open(native, O_CREAT | O_RDWR, 0600);
+    void* base = MAP_FAILED;
+    if (fd >= 0) {
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+            base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+    }
+    if (base == MAP_FAILED) {
+        LOG_MODULE("ShmRingSource", "map_segment", LOG_ERROR,
+            "创建共享内存段失败: " << native << "（" << std::strerror(errno) << "）");
+        if (fd >= 0) {
+            shm_unlink(native);
+        }
+        return false;
+    }
+#endif
+    ring_ = static_cast<dglab_shm_ring*>(base);
+    bytes_ = bytes;
+    return true;
+}
+
+void ShmRingSource::unmap_segment() {
+#ifdef _WIN32
+    UnmapViewOfFile(ring_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    char native[256];
+    dglab_shm_ring_native_name(name_.c_str(), native, sizeof(native));
+    munmap(ring_, bytes_);
+    shm_unlink(native);
+#endif
+    ring_ = nullptr;
+    bytes_ = 0;
+}
+
+void ShmRingSource::run() {
+    int idle = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        if (consume() > 0) {
+            idle = 0;
+            continue;
+        }
+        // 空闲退避：先自旋（高频生产时保持微秒级延迟），再让出时间片，持续空闲后短暂休眠
+        ++idle;
+        if (idle < SPIN_ITERATIONS) {
+            continue;
+        }
+        if (idle < SPIN_ITERATIONS + YIELD_ITERATIONS) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_US));
+        }
+    }
+}
+
+size_t ShmRingSource::consume() {
+    uint64_t tail = ring_->tail; // 仅消费者写入
+    // 共享内存中的计数与 C 端使用同一组原子访问宏
+    uint64_t head = DGLAB_SHM_LOAD_ACQUIRE(&ring_->head);
+    if (head == tail) {
+        return 0;
+    }
+    uint64_t capacity = ring_->capacity;
+    if (head - tail > capacity) {
+        // 生产者违反协议（越过未消费的记录），丢弃无法保证完整的部分
+        LOG_MODULE("ShmRingSource", "consume", LOG_WARN,
+            "共享内存环计数异常（head=" << head << "，tail=" << tail << "），跳过 " << head - tail - capacity << " 条记录");
+        tail = head - capacity;
+    }
+    if (keys_stale_.exchange(false, std::memory_order_acq_rel)) {
+        keys_.clear();
+    }
+
+    auto& manager = ModuleManager::instance();
+    const dglab_shm_record* records = dglab_shm_ring_records(ring_);
+    size_t count = static_cast<size_t>(head - tail);
+    for (; tail != head; ++tail) {
+        // 直接在共享内存中读取记录：ID 以视图引用，只取出 4 字节数值
+        const dglab_shm_record& record = records[tail & (capacity - 1)];
+        std::string_view value_id(record.value_id, strnlen(record.value_id, DGLAB_SHM_VALUE_ID_SIZE));
+        uint32_t key = resolve_key(value_id);
+        if (key != UNKNOWN_KEY) {
+            manager.publish_by_key(key, record.value);
+        }
+    }
+    DGLAB_SHM_STORE_RELEASE(&ring_->tail, tail);
+    consumed_.fetch_add(count, std::memory_order_relaxed);
+
+    // 丢弃数按倍数增长时才记录，避免持续满载时刷屏
+    uint64_t dropped = DGLAB_SHM_LOAD_ACQUIRE(&ring_->dropped);
+    if (dropped > reported_dropped_ && dropped >= reported_dropped_ * 2) {
+        LOG_MODULE("ShmRingSource", "consume", LOG_WARN,
+            "共享内存环已满，生产者累计丢弃 " << dropped << " 条记录（可增大 app.shm.capacity）");
+        reported_dropped_ = dropped;
+    }
+    return count;
+}
+
+uint32_t ShmRingSource::resolve_key(std::string_view value_id) {
+    auto it = keys_.find(value_id);
+    if (it != keys_.end()) {
+        return it->second;
+    }
+    auto key = ModuleManager::instance().find_value_key(value_id);
+    if (!key) {
+        LOG_MODULE("ShmRingSource", "resolve_key", LOG_WARN,
+            "共享内存记录引用了未注册的数值: " << value_id << "（已忽略）");
+    }
+    uint32_t resolved = key.value_or(UNKNOWN_KEY);
+    keys_.emplace(std::string(value_id), resolved);
+    return resolved;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+
+// ============================================
+// 公共接口实现（public）
+// ============================================
+
+void TimerWheel::clear() {
+    for (auto& level : slots_) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    occupied_.fill(0);
+    generations_.clear();
+    due_ticks_.clear();
+    now_tick_ = 0;
+}
+
+void TimerWheel::schedule(uint32_t key, uint64_t due_tick) {
+    if (key >= generations_.size()) {
+        generations_.resize(static_cast<size_t>(key) + 1, 0);
+        due_ticks_.resize(static_cast<size_t>(key) + 1);
+    }
+    // 递增代际号即可使旧条目失效，无需在槽位中查找删除
+    uint32_t generation = ++generations_[key];
+    uint64_t due = std::max(due_tick, now_tick_ + 1);
+    due_ticks_[key] = due;
+    place(Entry{ key, generation, due });
+}
+
+void TimerWheel::cancel(uint32_t key) {
+    if (key >= generations_.size()) {
+        return;
+    }
+    ++generations_[key];
+    due_ticks_[key].reset();
+}
+
+void TimerWheel::advance(uint64_t now_tick, std::vector<Expired>& expired) {
+    while (now_tick_ < now_tick) {
+        // 下一事件：本轮内最近的最底层占用槽位，或下一个 64 刻度边界（需下沉高层槽位）
+        size_t current = static_cast<size_t>(now_tick_ & (SLOT_COUNT - 1));
+        uint64_t next = (now_tick_ | (SLOT_COUNT - 1)) + 1;
+        if (current + 1 < SLOT_COUNT) {
+            uint64_t mask = occupied_[0] & (~uint64_t{ 0 } << (current + 1));
+            if (mask != 0) {
+                next = now_tick_ - current + static_cast<uint64_t>(std::countr_zero(mask));
+            }
+        }
+        if (next > now_tick) {
+            // 目标刻度前没有任何事件，直接跳过空槽
+            now_tick_ = now_tick;
+            break;
+        }
+        now_tick_ = next;
+        if ((now_tick_ & (SLOT_COUNT - 1)) == 0) {
+            // 自高层向低层依次下沉：高层条目可能落入随后要下沉的低层当前槽位
+            size_t top = 1;
+            while (top + 1 < LEVEL_COUNT && ((now_tick_ >> (SLOT_BITS * top)) & (SLOT_COUNT - 1)) == 0) {
+                ++top;
+            }
+            for (size_t level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+        expire_current(expired);
+    }
+}
+
+std::optional<uint64_t> TimerWheel::next_due_tick() const {
+    std::optional<uint64_t> best;
+    for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+        // 按推进顺序（当前槽位之后依次环绕）查找含有效条目的槽位
+        size_t current = static_cast<size_t>((now_tick_ >> (SLOT_BITS * level)) & (SLOT_COUNT - 1));
+        uint64_t rotated = std::rotr(occupied_[level], static_cast<int>((current + 1) % SLOT_COUNT));
+        while (rotated != 0) {
+            size_t offset = static_cast<size_t>(std::countr_zero(rotated));
+            rotated &= rotated - 1;
+            size_t slot = (current + 1 + offset) % SLOT_COUNT;
+            std::optional<uint64_t> slot_best;
+            for (const auto& entry : slots_[level][slot]) {
+                if (is_live(entry) && (!slot_best || entry.due_tick < *slot_best)) {
+                    slot_best = entry.due_tick;
+                }
+            }
+            if (slot_best && (!best || *slot_best < *best)) {
+                best = slot_best;
+            }
+            // 最高层可能暂存超出跨度的条目，需检查全部槽位；其余层第一个有效槽位即为该层最早
+            if (slot_best && level + 1 < LEVEL_COUNT) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+std::optional<uint64_t> TimerWheel::get_due_tick(uint32_t key) const {
+    return key < due_ticks_.size() ? due_ticks_[key] : std::nullopt;
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+void TimerWheel::place(const Entry& entry) {
+    uint64_t delta = entry.due_tick > now_tick_ ? entry.due_tick - now_tick_ : 0;
+    size_t level = 0;
+    while (level + 1 < LEVEL_COUNT && delta >= (uint64_t{ 1 } << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    size_t slot;
+    if (delta >= (uint64_t{ 1 } << (SLOT_BITS * LEVEL_COUNT))) {
+        // 超出时间轮跨度：暂存到最高层最后被推进到的槽位，下沉时按实际到期刻度重新放置
+        slot = static_cast<size_t>(((now_tick_ >> (SLOT_BITS * level)) + SLOT_COUNT - 1) & (SLOT_COUNT - 1));
+    }
+    else {
+        slot = static_cast<size_t>((entry.due_tick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1));
+    }
+    slots_[level][slot].push_back(entry);
+    occupied_[level] |= uint64_t{ 1 } << slot;
+}
+
+void TimerWheel::cascade(size_t level) {
+    size_t slot = static_cast<size_t>((now_tick_ >> (SLOT_BITS * level)) & (SLOT_COUNT - 1));
+    if ((occupied_[level] & (uint64_t{ 1 } << slot)) == 0) {
+        return;
+    }
+    std::vector<Entry> entries;
+    entries.swap(slots_[level][slot]);
+    occupied_[level] &= ~(uint64_t{ 1 } << slot);
+    for (const auto& entry : entries) {
+        // 过期条目在此丢弃
+        if (is_live(entry)) {
+            place(entry);
+        }
+    }
+}
+
+void TimerWheel::expire_current(std::vector<Expired>& expired) {
+    size_t slot = static_cast<size_t>(now_tick_ & (SLOT_COUNT - 1));
+    if ((occupied_[0] & (uint64_t{ 1 } << slot)) == 0) {
+        return;
+    }
+    std::vector<Entry> entries;
+    entries.swap(slots_[0][slot]);
+    occupied_[0] &= ~(uint64_t{ 1 } << slot);
+    for (const auto& entry : entries) {
+        if (!is_live(entry)) {
+            continue;
+        }
+        if (entry.due_tick <= now_tick_) {
+            due_ticks_[entry.key].reset();
+            expired.push_back(Expired{ entry.key, entry.due_tick });
+        }
+        else {
+            place(entry);
+        }
+    }
+}
+
+bool TimerWheel::is_live(const Entry& entry) const {
+    return generations_[entry.key] == entry.generation;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "ValueHistory.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+// 每个样本占用的字节数：时间戳 + 数值 + 前缀和 + 两个单调队列槽位
+constexpr size_t BYTES_PER_SAMPLE = sizeof(int64_t) + sizeof(int32_t) + sizeof(int64_t) + 2 * sizeof(uint64_t);
+} // namespace
+
+// ============================================
+// 构造/析构（public）
+// ============================================
+
+ValueHistory::ValueHistory(size_t memory_budget, int window_ms)
+    : capacity_(std::max(MIN_CAPACITY, std::bit_floor(std::max<size_t>(memory_budget / BYTES_PER_SAMPLE, 1))))
+    , mask_(capacity_ - 1)
+    , window_ns_(static_cast<int64_t>(std::max(window_ms, 1)) * 1'000'000)
+    , timestamps_(new std::atomic<int64_t>[capacity_])
+    , values_(new std::atomic<int32_t>[capacity_])
+    , prefix_(new std::atomic<int64_t>[capacity_])
+    , min_queue_(new uint64_t[capacity_])
+    , max_queue_(new uint64_t[capacity_]) {
+    for (size_t i = 0; i < capacity_; ++i) {
+        timestamps_[i].store(0, std::memory_order_relaxed);
+        values_[i].store(0, std::memory_order_relaxed);
+        prefix_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// ============================================
+// 写入（public）
+// ============================================
+
+void ValueHistory::push(int64_t timestamp_ns, int value) {
+    uint64_t seq = head_.load(std::memory_order_relaxed);
+    // 写入将覆盖序号 seq - capacity 的样本：窗口至多保留 capacity - 1 个旧样本
+    while (window_begin_ + capacity_ <= seq) {
+        evict_front();
+    }
+    // 前一个样本直到写入序号 seq - 1 + capacity 才会被覆盖，此时必然仍在环中
+    // 以 64 位求差：接近 INT_MIN/INT_MAX 的数值相减在 int 下会溢出
+    int64_t last_delta = seq > 0
+        ? static_cast<int64_t>(value) - values_[slot_of(seq - 1)].load(std::memory_order_relaxed) : 0;
+
+    size_t slot = slot_of(seq);
+    // 与读取方的获取屏障配对（同统计快照的序号锁）：读到本次覆盖写入的读取方，必然也看到此前发布的 head_，
+    // 复查 head_ 时能发现槽位已被覆盖；否则槽位写入可能早于上一次 head_ 的发布被观察到，读到撕裂的样本
+    std::atomic_thread_fence(std::memory_order_release);
+    timestamps_[slot].store(timestamp_ns, std::memory_order_relaxed);
+    values_[slot].store(value, std::memory_order_relaxed);
+    prefix_[slot].store(running_total_, std::memory_order_relaxed);
+    running_total_ += value;
+    head_.store(seq + 1, std::memory_order_release);
+
+    // 单调队列：最小值队列保持值递增，最大值队列保持值递减，队首即窗口极值
+    while (min_back_ > min_front_
+        && values_[slot_of(min_queue_[(min_back_ - 1) & mask_])].load(std::memory_order_relaxed) >= value) {
+        --min_back_;
+    }
+    min_queue_[min_back_++ & mask_] = seq;
+    while (max_back_ > max_front_
+        && values_[slot_of(max_queue_[(max_back_ - 1) & mask_])].load(std::memory_order_relaxed) <= value) {
+        --max_back_;
+    }
+    max_queue_[max_back_++ & mask_] = seq;
+    window_sum_ += value;
+
+    // 时间窗口：移出早于 timestamp - window 的样本（最新样本始终保留）
+    while (window_begin_ < seq
+        && timestamp_ns - timestamps_[slot_of(window_begin_)].load(std::memory_order_relaxed) > window_ns_) {
+        evict_front();
+    }
+    publish_stats(last_delta);
+}
+
+void ValueHistory::clear() {
+    head_.store(0, std::memory_order_release);
+    min_front_ = min_back_ = 0;
+    max_front_ = max_back_ = 0;
+    window_begin_ = 0;
+    window_sum_ = 0;
+    running_total_ = 0;
+    stats_seq_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    stats_count_.store(0, std::memory_order_relaxed);
+    stats_seq_.fetch_add(1, std::memory_order_release);
+}
+
+// ============================================
+// 读取（public）
+// ============================================
+
+size_t ValueHistory::size() const {
+    return static_cast<size_t>(std::min<uint64_t>(head_.load(std::memory_order_acquire), capacity_ - 1));
+}
+
+std::optional<ValueHistory::Sample> ValueHistory::latest() const {
+    while (true) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        if (head == 0) {
+            return std::nullopt;
+        }
+        size_t slot = slot_of(head - 1);
+        Sample sample{ timestamps_[slot].load(std::memory_order_relaxed),
+            values_[slot].load(std::memory_order_relaxed) };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 写入方正在写入序号 head_ 时会覆盖序号 head_ - capacity 的槽位，读取的序号比它新即有效
+        if (head_.load(std::memory_order_relaxed) < head - 1 + capacity_) {
+            return sample;
+        }
+    }
+}
+
+ValueHistory::WindowStats ValueHistory::window_stats() const {
+    WindowStats stats;
+    while (true) {
+        uint64_t begin = stats_seq_.load(std::memory_order_acquire);
+        if (begin & 1) {
+            continue;
+        }
+        stats.count = static_cast<size_t>(stats_count_.load(std::memory_order_relaxed));
+        stats.min = stats_min_.load(std::memory_order_relaxed);
+        stats.max = stats_max_.load(std::memory_order_relaxed);
+        stats.sum = stats_sum_.load(std::memory_order_relaxed);
+        stats.last_delta = stats_last_delta_.load(std::memory_order_relaxed);
+        stats.latest_ns = stats_latest_ns_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (stats_seq_.load(std::memory_order_relaxed) == begin) {
+            return stats;
+        }
+    }
+}
+
+int64_t ValueHistory::sum_recent(size_t count) const {
+    while (true) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t n = std::min<uint64_t>({ count, head, capacity_ - 1 });
+        if (n == 0) {
+            return 0;
+        }
+        // 前缀和不含样本自身：区间和 = (最新样本前缀和 + 最新值) - 区间首个样本前缀和
+        size_t last = slot_of(head - 1);
+        int64_t total = prefix_[last].load(std::memory_order_relaxed) + values_[last].load(std::memory_order_relaxed);
+        int64_t before = prefix_[slot_of(head - n)].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head_.load(std::memory_order_relaxed) < head - n + capacity_) {
+            return total - before;
+        }
+    }
+}
+
+size_t ValueHistory::read_recent(std::span<Sample> out) const {
+    while (true) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t n = std::min<uint64_t>({ out.size(), head, capacity_ - 1 });
+        uint64_t first = head - n;
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t slot = slot_of(first + i);
+            out[i] = Sample{ timestamps_[slot].load(std::memory_order_relaxed),
+                values_[slot].load(std::memory_order_relaxed) };
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (n == 0 || head_.load(std::memory_order_relaxed) < first + capacity_) {
+            return static_cast<size_t>(n);
+        }
+    }
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+void ValueHistory::evict_front() {
+    window_sum_ -= values_[slot_of(window_begin_)].load(std::memory_order_relaxed);
+    if (min_back_ > min_front_ && min_queue_[min_front_ & mask_] == window_begin_) {
+        ++min_front_;
+    }
+    if (max_back_ > max_front_ && max_queue_[max_front_ & mask_] == window_begin_) {
+        ++max_front_;
+    }
+    ++window_begin_;
+}
+
+void ValueHistory::publish_stats(int64_t last_delta) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    stats_seq_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    stats_count_.store(head - window_begin_, std::memory_order_relaxed);
+    stats_min_.store(values_[slot_of(min_queue_[min_front_ & mask_])].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    stats_max_.store(values_[slot_of(max_queue_[max_front_ & mask_])].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    stats_sum_.store(window_sum_, std::memory_order_relaxed);
+    stats_last_delta_.store(last_delta, std::memory_order_relaxed);
+    stats_latest_ns_.store(timestamps_[slot_of(head - 1)].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    stats_seq_.fetch_add(1, std::memory_order_release);
+}
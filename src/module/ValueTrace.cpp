@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "ValueTrace.h"
+
+#include "DebugLog.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// 记录按小端序写入；目标平台（x86/ARM Windows、Linux）均为小端，直接按内存布局拷贝
+template<typename T>
+void store_at(uchar* dst, T value) {
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+template<typename T>
+T load_at(const uchar* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+} // namespace
+
+// ============================================
+// ValueTraceWriter（public）
+// ============================================
+
+ValueTraceWriter::~ValueTraceWriter() {
+    close();
+}
+
+bool ValueTraceWriter::open(const QString& path) {
+    close();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        LOG_MODULE("ValueTraceWriter", "open", LOG_ERROR,
+            "无法创建轨迹文件: " << path.toStdString() << "（" << file_.errorString().toStdString() << "）");
+        return false;
+    }
+    length_ = 0;
+    mapped_size_ = 0;
+    base_ns_ = 0;
+    sample_count_ = 0;
+    ids_.clear();
+    if (!reserve(static_cast<qint64>(ValueTrace::HEADER_BYTES))) {
+        return false;
+    }
+    uchar header[ValueTrace::HEADER_BYTES] = {};
+    std::memcpy(header, ValueTrace::MAGIC, sizeof(ValueTrace::MAGIC));
+    store_at<uint32_t>(header + 8, ValueTrace::VERSION);
+    store_at<int64_t>(header + 16, QDateTime::currentMSecsSinceEpoch());
+    write_bytes(header, sizeof(header));
+    LOG_MODULE("ValueTraceWriter", "open", LOG_INFO, "开始录制数值轨迹: " << path.toStdString());
+    return true;
+}
+
+void ValueTraceWriter::close() {
+    if (map_ != nullptr) {
+        file_.unmap(map_);
+        map_ = nullptr;
+        file_.resize(length_);
+        LOG_MODULE("ValueTraceWriter", "close", LOG_INFO,
+            "数值轨迹录制结束: " << sample_count_ << " 个样本，" << length_ << " 字节");
+    }
+    if (file_.isOpen()) {
+        file_.close();
+    }
+}
+
+bool ValueTraceWriter::append(int64_t timestamp_ns, const std::string& value_id, int value) {
+    if (map_ == nullptr) {
+        return false;
+    }
+    if (sample_count_ == 0) {
+        base_ns_ = timestamp_ns;
+    }
+    auto it = ids_.find(value_id);
+    if (it == ids_.end()) {
+        if (ids_.size() > UINT16_MAX || value_id.size() > UINT16_MAX) {
+            return false;
+        }
+        size_t record_bytes = ValueTrace::DEFINE_HEADER_BYTES + value_id.size();
+        if (!reserve(static_cast<qint64>(record_bytes + ValueTrace::SAMPLE_BYTES))) {
+            return false;
+        }
+        uint16_t index = static_cast<uint16_t>(ids_.size());
+        uchar define[ValueTrace::DEFINE_HEADER_BYTES] = {};
+        define[0] = static_cast<uchar>(ValueTrace::RecordKind::DEFINE);
+        store_at<uint16_t>(define + 2, index);
+        store_at<uint16_t>(define + 4, static_cast<uint16_t>(value_id.size()));
+        write_bytes(define, sizeof(define));
+        write_bytes(value_id.data(), value_id.size());
+        it = ids_.emplace(value_id, index).first;
+    }
+    else if (!reserve(static_cast<qint64>(ValueTrace::SAMPLE_BYTES))) {
+        return false;
+    }
+    uchar sample[ValueTrace::SAMPLE_BYTES] = {};
+    sample[0] = static_cast<uchar>(ValueTrace::RecordKind::SAMPLE);
+    store_at<uint16_t>(sample + 2, it->second);
+    store_at<int32_t>(sample + 4, value);
+    store_at<int64_t>(sample + 8, timestamp_ns - base_ns_);
+    write_bytes(sample, sizeof(sample));
+    ++sample_count_;
+    return true;
+}
+
+// ============================================
+// ValueTraceWriter（private）
+// ============================================
+
+bool ValueTraceWriter::reserve(qint64 bytes) {
+    if (length_ + bytes <= mapped_size_) {
+        return true;
+    }
+    if (map_ != nullptr) {
+        file_.unmap(map_);
+        map_ = nullptr;
+    }
+    qint64 new_size = std::max(mapped_size_ + GROW_BYTES, length_ + bytes);
+    if (file_.resize(new_size)) {
+        map_ = file_.map(0, new_size);
+    }
+    if (map_ == nullptr) {
+        LOG_MODULE("ValueTraceWriter", "reserve", LOG_ERROR,
+            "扩展轨迹文件失败，录制已停止: " << file_.errorString().toStdString());
+        file_.resize(length_);
+        file_.close();
+        mapped_size_ = 0;
+        return false;
+    }
+    mapped_size_ = new_size;
+    return true;
+}
+
+void ValueTraceWriter::write_bytes(const void* data, size_t size) {
+    std::memcpy(map_ + length_, data, size);
+    length_ += static_cast<qint64>(size);
+}
+
+// ============================================
+// ValueTraceReader（public）
+// ============================================
+
+ValueTraceReader::~ValueTraceReader() {
+    close();
+}
+
+bool ValueTraceReader::open(const QString& path) {
+    close();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        LOG_MODULE("ValueTraceReader", "open", LOG_ERROR,
+            "无法打开轨迹文件: " << path.toStdString() << "（" << file_.errorString().toStdString() << "）");
+        return false;
+    }
+    size_ = file_.size();
+    if (size_ >= static_cast<qint64>(ValueTrace::HEADER_BYTES)) {
+        data_ = file_.map(0, size_);
+    }
+    if (data_ == nullptr
+        || std::memcmp(data_, ValueTrace::MAGIC, sizeof(ValueTrace::MAGIC)) != 0
+        || load_at<uint32_t>(data_ + 8) != ValueTrace::VERSION) {
+        LOG_MODULE("ValueTraceReader", "open", LOG_ERROR, "不是有效的数值轨迹文件: " << path.toStdString());
+        close();
+        return false;
+    }
+    start_unix_ms_ = load_at<int64_t>(data_ + 16);
+    ids_.clear();
+    rewind();
+    return true;
+}
+
+void ValueTraceReader::close() {
+    if (data_ != nullptr) {
+        file_.unmap(const_cast<uchar*>(data_));
+        data_ = nullptr;
+    }
+    if (file_.isOpen()) {
+        file_.close();
+    }
+    size_ = 0;
+    pos_ = 0;
+}
+
+bool ValueTraceReader::next(ValueTrace::Sample& out) {
+    while (data_ != nullptr && pos_ < size_) {
+        const uchar* record = data_ + pos_;
+        qint64 remaining = size_ - pos_;
+        auto kind = static_cast<ValueTrace::RecordKind>(record[0]);
+        if (kind == ValueTrace::RecordKind::SAMPLE && remaining >= static_cast<qint64>(ValueTrace::SAMPLE_BYTES)) {
+            out.value_index = load_at<uint16_t>(record + 2);
+            out.value = load_at<int32_t>(record + 4);
+            out.timestamp_ns = load_at<int64_t>(record + 8);
+            pos_ += static_cast<qint64>(ValueTrace::SAMPLE_BYTES);
+            return true;
+        }
+        if (kind == ValueTrace::RecordKind::DEFINE && remaining >= static_cast<qint64>(ValueTrace::DEFINE_HEADER_BYTES)) {
+            uint16_t index = load_at<uint16_t>(record + 2);
+            size_t length = load_at<uint16_t>(record + 4);
+            if (remaining < static_cast<qint64>(ValueTrace::DEFINE_HEADER_BYTES + length)) {
+                break;
+            }
+            if (ids_.size() <= index) {
+                ids_.resize(static_cast<size_t>(index) + 1);
+            }
+            ids_[index].assign(reinterpret_cast<const char*>(record + ValueTrace::DEFINE_HEADER_BYTES), length);
+            pos_ += static_cast<qint64>(ValueTrace::DEFINE_HEADER_BYTES + length);
+            continue;
+        }
+        if (kind != ValueTrace::RecordKind::END) {
+            LOG_MODULE("ValueTraceReader", "next", LOG_WARN, "轨迹记录损坏，停止读取（偏移 " << pos_ << "）");
+        }
+        break;
+    }
+    return false;
+}
+
+void ValueTraceReader::rewind() {
+    pos_ = static_cast<qint64>(ValueTrace::HEADER_BYTES);
+}
+
+const std::string& ValueTraceReader::get_value_id(uint16_t value_index) const {
+    static const std::string empty;
+    return value_index < ids_.size() ? ids_[value_index] : empty;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "ValueTraceReplayer.h"
+
+#include "DebugLog.h"
+#include "ModuleManager.h"
+
+#include <chrono>
+
+namespace {
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+// ============================================
+// 构造/析构（public）
+// ============================================
+
+ValueTraceReplayer::ValueTraceReplayer(QObject* parent)
+    : QObject(parent)
+    , timer_(new QTimer(this)) {
+    timer_->setSingleShot(true);
+    connect(timer_, &QTimer::timeout, this, [this]() { step(); });
+}
+
+// ============================================
+// 公共接口（public）
+// ============================================
+
+bool ValueTraceReplayer::start(const QString& path, double speed) {
+    stop();
+    if (!reader_.open(path)) {
+        return false;
+    }
+    speed_ = speed;
+    sample_count_ = 0;
+    start_ns_ = steady_now_ns();
+    running_ = true;
+    read_next();
+    LOG_MODULE("ValueTraceReplayer", "start", LOG_INFO,
+        "开始回放数值轨迹: " << path.toStdString() << "，倍速 " << speed_ << (speed_ > 0 ? "" : "（尽快回放）"));
+    timer_->start(0);
+    return true;
+}
+
+void ValueTraceReplayer::stop() {
+    timer_->stop();
+    reader_.close();
+    pending_.reset();
+    if (running_) {
+        // 丢弃回放留下的历史与变化判定基准，实时数值从干净的状态开始
+        ModuleManager::instance().reset_value_states();
+    }
+    running_ = false;
+}
+
+// ============================================
+// 私有辅助函数实现（private）
+// ============================================
+
+void ValueTraceReplayer::step() {
+    auto& manager = ModuleManager::instance();
+    int batches = 0;
+    while (pending_) {
+        int64_t trace_ns = pending_->timestamp_ns;
+        if (speed_ > 0) {
+            // 按倍速换算样本在回放时间线上的时刻，未到期则等待
+            int64_t offset_ns = static_cast<int64_t>(static_cast<double>(trace_ns) / speed_);
+            int64_t wait_ns = start_ns_ + offset_ns - steady_now_ns();
+            if (wait_ns > 0) {
+                timer_->start(static_cast<int>((wait_ns + 999'999) / 1'000'000));
+                return;
+            }
+        }
+        if (batches >= FAST_BATCHES_PER_TURN) {
+            // 让出事件循环（界面刷新、停止回放），下一轮继续
+            timer_->start(0);
+            return;
+        }
+        batch_.clear();
+        while (pending_ && pending_->timestamp_ns == trace_ns) {
+            batch_.emplace_back(reader_.get_value_id(pending_->value_index), pending_->value);
+            read_next();
+        }
+        sample_count_ += static_cast<qint64>(batch_.size());
+        // 以实际推送时刻为时间戳（录制时刻不写入数值状态，避免尽快回放时出现未来时刻）；回放不接管轮询
+        manager.push_values(batch_, false);
+        ++batches;
+    }
+
+    qint64 elapsed_ms = (steady_now_ns() - start_ns_) / 1'000'000;
+    LOG_MODULE("ValueTraceReplayer", "step", LOG_INFO,
+        "数值轨迹回放完成: " << sample_count_ << " 个样本，耗时 " << elapsed_ms << "ms");
+    stop();
+    emit finished(sample_count_, elapsed_ms);
+}
+
+void ValueTraceReplayer::read_next() {
+    ValueTrace::Sample sample;
+    if (reader_.next(sample)) {
+        pending_ = sample;
+    }
+    else {
+        pending_.reset();
+    }
+}
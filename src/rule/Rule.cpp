@@ -130,6 +130,24 @@ std::optional<int> Rule::compute_value(const std::vector<std::optional<int>>& va
         LOG_MODULE("Rule", "computeValue", LOG_WARN, "规则 " << name_ << " 值模式为空，忽略计算");
         return std::nullopt;
     }
+    if (values.size() != placeholder_count_) {
+        LOG_MODULE("Rule", "computeValue", LOG_ERROR,
+            "规则 " << name_ << " 需要 " << placeholder_count_ << " 个参数，实际收到 " << values.size());
+        return std::nullopt;
+    }
+    for (const auto& value : values) {
+        if (!value.has_value()) {
+            // 任一占位符为空值，该项被忽略（返回空，由调用方决定是否跳过）
+            LOG_MODULE("Rule", "computeValue", LOG_DEBUG,
+                "规则 " << name_ << " 存在空值占位符，本次计算被忽略");
+            return std::nullopt;
+        }
+    }
+    // 快速路径：已编译的字节码直接按槽位求值
+    if (program_.is_native()) {
+        return clamp_by_mode(program_.evaluate(values));
+    }
+    // 回退路径：替换占位符后交给 QJSEngine
     std::string expr = evaluate_value_pattern(values);
     if (expr.empty()) {
         // 任一占位符为空值，该项被忽略（返回空，由调用方决定是否跳过）
@@ -256,6 +274,17 @@ void Rule::parse_pattern() {
         ++placeholder_count_;
         pos = close + 1;
     }
+
+    // 编译为字节码（一次性），不支持的语法在求值时回退 QJSEngine
+    std::vector<ExprSlotSpan> spans;
+    spans.reserve(placeholders_.size());
+    for (const auto& ph : placeholders_) {
+        spans.push_back({ ph.pos, ph.len });
+    }
+    if (!program_.compile(pattern, spans) && !pattern.empty()) {
+        LOG_MODULE("Rule", "parsePattern", LOG_DEBUG,
+            "规则 " << name_ << " 值模式含不支持原生编译的语法，将回退 QJSEngine: " << pattern);
+    }
 }
 
 std::string Rule::evaluate_value_pattern(const std::vector<std::optional<int>>& values) const {
@@ -285,17 +314,18 @@ int Rule::evaluate_expression(const std::string& expr) const {
             "表达式求值失败: " << expr << ", 错误: " << result.toString().toStdString());
         return 0;
     }
-    int raw_value = result.toInt();
+    return clamp_by_mode(result.toInt());
+}
 
-    // 根据模式对结果进行范围钳位
+int Rule::clamp_by_mode(int raw_value) const {
     if (mode_ == 2) {
         raw_value = std::clamp(raw_value, 0, 200);
-        LOG_MODULE("Rule", "evaluateExpression", LOG_DEBUG,
+        LOG_MODULE("Rule", "clampByMode", LOG_DEBUG,
             "设为模式: 原始值 = " << raw_value << "（已钳位到 [0, 200]）");
     }
     else if (mode_ == 3 || mode_ == 4) {
         raw_value = std::clamp(raw_value, 1, 100);
-        LOG_MODULE("Rule", "evaluateExpression", LOG_DEBUG,
+        LOG_MODULE("Rule", "clampByMode", LOG_DEBUG,
             "连续模式: 重复次数 = " << raw_value << "（已钳位到 [1, 100]）");
     }
     return raw_value;
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "RuleExpression.h"
+
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+// ============================================
+// 编译器（匿名命名空间，仅本文件使用）
+// ============================================
+namespace {
+
+    /// @brief 递归下降解析器：中缀表达式 -> 后缀字节码
+    /// 语法:
+    ///   expr    := term (('+' | '-') term)*
+    ///   term    := unary (('*' | '/' | '%') unary)*
+    ///   unary   := ('+' | '-') unary | primary
+    ///   primary := NUMBER | SLOT | '(' expr ')'
+    class ExprCompiler {
+    public:
+        ExprCompiler(const std::string& pattern, const std::vector<ExprSlotSpan>& slots,
+            std::vector<ExprInstr>& code)
+            : pattern_(pattern)
+            , slots_(slots)
+            , code_(code) {
+        }
+
+        /// @brief 编译整个表达式
+        /// @return 成功返回 true，含不支持语法返回 false
+        bool run() {
+            skip_space();
+            if (!parse_expr()) {
+                return false;
+            }
+            skip_space();
+            return pos_ == pattern_.size();
+        }
+
+        /// @brief 编译过程中记录的最大栈深度
+        size_t max_depth() const { return max_depth_; }
+
+    private:
+        static constexpr int MAX_NESTING = 64; ///< 最大递归层数（防止病态输入栈溢出）
+
+        const std::string& pattern_;
+        const std::vector<ExprSlotSpan>& slots_;
+        std::vector<ExprInstr>& code_;
+        size_t pos_ = 0;        ///< 当前扫描位置
+        size_t next_slot_ = 0;  ///< 下一个待匹配的槽位序号
+        size_t depth_ = 0;      ///< 当前模拟栈深度
+        size_t max_depth_ = 0;  ///< 最大模拟栈深度
+        int nesting_ = 0;       ///< 当前递归层数
+
+        void skip_space() {
+            while (pos_ < pattern_.size()
+                && std::isspace(static_cast<unsigned char>(pattern_[pos_]))) {
+                ++pos_;
+            }
+        }
+
+        void emit(ExprOp op, uint32_t slot = 0, double value = 0.0) {
+            code_.push_back({ op, slot, value });
+            if (op == ExprOp::PUSH_CONST || op == ExprOp::PUSH_SLOT) {
+                ++depth_;
+                if (depth_ > max_depth_) {
+                    max_depth_ = depth_;
+                }
+            }
+            else if (op != ExprOp::NEG) {
+                --depth_;
+            }
+        }
+
+        /// @brief 当前位置是否恰为下一个占位符
+        bool at_slot() const {
+            return next_slot_ < slots_.size() && slots_[next_slot_].pos == pos_;
+        }
+
+        /// @brief 当前位置（跳过空白前）是否紧邻 ++/-- 记号（JS 中语义不同，交给回退路径）
+        bool at_double_sign(char op) const {
+            return pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == op;
+        }
+
+        bool parse_expr() {
+            if (++nesting_ > MAX_NESTING) {
+                return false;
+            }
+            if (!parse_term()) {
+                return false;
+            }
+            while (true) {
+                skip_space();
+                if (pos_ >= pattern_.size() || at_slot()) {
+                    break;
+                }
+                char c = pattern_[pos_];
+                if (c != '+' && c != '-') {
+                    break;
+                }
+                if (at_double_sign(c)) {
+                    return false;
+                }
+                ++pos_;
+                if (!parse_term()) {
+                    return false;
+                }
+                emit(c == '+' ? ExprOp::ADD : ExprOp::SUB);
+            }
+            --nesting_;
+            return true;
+        }
+
+        bool parse_term() {
+            if (!parse_unary()) {
+                return false;
+            }
+            while (true) {
+                skip_space();
+                if (pos_ >= pattern_.size() || at_slot()) {
+                    break;
+                }
+                char c = pattern_[pos_];
+                if (c != '*' && c != '/' && c != '%') {
+                    break;
+                }
+                // ** 为幂运算，/* 与 // 为注释，均交给回退路径
+                if (pos_ + 1 < pattern_.size()) {
+                    char n = pattern_[pos_ + 1];
+                    if (n == '*' || n == '/' || n == '=') {
+                        return false;
+                    }
+                }
+                ++pos_;
+                if (!parse_unary()) {
+                    return false;
+                }
+                emit(c == '*' ? ExprOp::MUL : (c == '/' ? ExprOp::DIV : ExprOp::MOD));
+            }
+            return true;
+        }
+
+        bool parse_unary() {
+            skip_space();
+            if (pos_ < pattern_.size() && !at_slot()) {
+                char c = pattern_[pos_];
+                if (c == '+' || c == '-') {
+                    if (at_double_sign(c)) {
+                        return false;
+                    }
+                    if (++nesting_ > MAX_NESTING) {
+                        return false;
+                    }
+                    ++pos_;
+                    if (!parse_unary()) {
+                        return false;
+                    }
+                    --nesting_;
+                    if (c == '-') {
+                        emit(ExprOp::NEG);
+                    }
+                    return true;
+                }
+            }
+            return parse_primary();
+        }
+
+        bool parse_primary() {
+            skip_space();
+            if (pos_ >= pattern_.size()) {
+                return false;
+            }
+            if (at_slot()) {
+                const ExprSlotSpan& span = slots_[next_slot_];
+                emit(ExprOp::PUSH_SLOT, static_cast<uint32_t>(next_slot_));
+                ++next_slot_;
+                pos_ = span.pos + span.len;
+                return true;
+            }
+            char c = pattern_[pos_];
+            if (c == '(') {
+                ++pos_;
+                if (!parse_expr()) {
+                    return false;
+                }
+                skip_space();
+                if (pos_ >= pattern_.size() || at_slot() || pattern_[pos_] != ')') {
+                    return false;
+                }
+                ++pos_;
+                return true;
+            }
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                return parse_number();
+            }
+            // 其他字符（标识符、比较/位运算、未识别的花括号等）交给回退路径
+            return false;
+        }
+
+        bool parse_number() {
+            size_t start = pos_;
+            size_t int_digits = 0;
+            while (pos_ < pattern_.size() && std::isdigit(static_cast<unsigned char>(pattern_[pos_]))) {
+                ++pos_;
+                ++int_digits;
+            }
+            // 前导零的多位整数在 JS 中可能按八进制解释，交给回退路径
+            if (int_digits > 1 && pattern_[start] == '0') {
+                return false;
+            }
+            size_t frac_digits = 0;
+            if (pos_ < pattern_.size() && pattern_[pos_] == '.') {
+                ++pos_;
+                while (pos_ < pattern_.size()
+                    && std::isdigit(static_cast<unsigned char>(pattern_[pos_]))) {
+                    ++pos_;
+                    ++frac_digits;
+                }
+            }
+            if (int_digits == 0 && frac_digits == 0) {
+                return false;
+            }
+            // 数字后紧跟字母/点/占位符（指数、十六进制、成员访问等）交给回退路径
+            if (pos_ < pattern_.size()) {
+                char n = pattern_[pos_];
+                if (std::isalnum(static_cast<unsigned char>(n)) || n == '.' || n == '_' || at_slot()) {
+                    return false;
+                }
+            }
+            std::string text = pattern_.substr(start, pos_ - start);
+            emit(ExprOp::PUSH_CONST, 0, std::strtod(text.c_str(), nullptr));
+            return true;
+        }
+    };
+
+    /// @brief 按 JS ToInt32 语义将双精度数转为 32 位整数
+    int to_int32(double value) {
+        if (!std::isfinite(value)) {
+            return 0;
+        }
+        double truncated = std::trunc(value);
+        double wrapped = std::fmod(truncated, 4294967296.0);
+        if (wrapped < 0) {
+            wrapped += 4294967296.0;
+        }
+        uint32_t bits = static_cast<uint32_t>(wrapped);
+        return static_cast<int>(bits);
+    }
+
+} // namespace
+
+// ============================================
+// 公共接口实现（public）
+// ============================================
+
+bool RuleExpression::compile(const std::string& pattern, const std::vector<ExprSlotSpan>& slots) {
+    code_.clear();
+    native_ = false;
+    if (pattern.empty()) {
+        return false;
+    }
+    ExprCompiler compiler(pattern, slots, code_);
+    if (!compiler.run() || compiler.max_depth() > MAX_STACK_DEPTH) {
+        code_.clear();
+        return false;
+    }
+    native_ = true;
+    return true;
+}
+
+int RuleExpression::evaluate(const std::vector<std::optional<int>>& values) const {
+    std::array<double, MAX_STACK_DEPTH> stack;
+    size_t top = 0;
+    for (const ExprInstr& instr : code_) {
+        switch (instr.op) {
+        case ExprOp::PUSH_CONST:
+            stack[top++] = instr.value;
+            break;
+        case ExprOp::PUSH_SLOT:
+            stack[top++] = static_cast<double>(values[instr.slot].value_or(0));
+            break;
+        case ExprOp::NEG:
+            stack[top - 1] = -stack[top - 1];
+            break;
+        default: {
+            double rhs = stack[--top];
+            double& lhs = stack[top - 1];
+            switch (instr.op) {
+            case ExprOp::ADD: lhs += rhs; break;
+            case ExprOp::SUB: lhs -= rhs; break;
+            case ExprOp::MUL: lhs *= rhs; break;
+            case ExprOp::DIV: lhs /= rhs; break;
+            case ExprOp::MOD: lhs = std::fmod(lhs, rhs); break;
+            default: break;
+            }
+            break;
+        }
+        }
+    }
+    return top == 1 ? to_int32(stack[0]) : 0;
+}
@@ -10,12 +10,18 @@
 #include "DebugLog.h"
 #include "ModuleManager.h"
 
+#include <QCoreApplication>
 #include <QJsonObject>
+#include <QMetaObject>
 #include <QRegularExpression>
+#include <QThread>
+#include <QTimer>
 
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <map>
 #include <mutex>
 
 namespace fs = std::filesystem;
@@ -34,13 +40,21 @@ RuleManager& RuleManager::instance() {
 // ============================================
 
 RuleManager::RuleManager()
-    : QObject(nullptr) {
-    // 监听模块数值变化，触发值模式中引用该数值的规则计算（级联触发）
-    connect(&ModuleManager::instance(), &ModuleManager::value_changed,
-        this, &RuleManager::on_module_value_changed);
+    : QObject(nullptr)
+    , result_slots_(std::make_shared<std::vector<ModuleValueSlot>>()) {
+    // 发布空快照，保证查询接口始终可读
+    publish_snapshot_locked();
+    // 监听模块数值批量变化，触发值模式中引用这些数值的规则计算（每批次一个传播波次）
+    connect(&ModuleManager::instance(), &ModuleManager::values_changed,
+        this, &RuleManager::on_module_values_changed);
+    // 模块注册完成后重新绑定数值槽位（规则通常先于模块加载）
+    connect(&ModuleManager::instance(), &ModuleManager::values_registered,
+        this, &RuleManager::on_module_values_registered);
 }
 
-RuleManager::~RuleManager() = default;
+RuleManager::~RuleManager() {
+    shutdown();
+}
 
 // ============================================
 // 初始化（public）
@@ -61,6 +75,33 @@ void RuleManager::init() {
         LOG_MODULE("RuleManager", "init", LOG_ERROR, "创建目录失败: " << e.what());
     }
     scan_directory();
+
+    if (worker_thread_ == nullptr) {
+        // 规则计算工作线程：模块数值变化在此线程批量计算，不占用 GUI 线程
+        worker_thread_ = new QThread();
+        worker_thread_->setObjectName("RuleEngine");
+        worker_ = new QObject();
+        worker_->moveToThread(worker_thread_);
+        connect(worker_thread_, &QThread::finished, worker_, &QObject::deleteLater);
+        if (QCoreApplication::instance() != nullptr) {
+            connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &RuleManager::shutdown);
+        }
+        worker_thread_->start();
+        LOG_MODULE("RuleManager", "init", LOG_INFO, "规则计算工作线程已启动");
+    }
+}
+
+void RuleManager::shutdown() {
+    if (worker_thread_ == nullptr) {
+        return;
+    }
+    worker_thread_->quit();
+    worker_thread_->wait();
+    delete worker_thread_;
+    worker_thread_ = nullptr;
+    worker_ = nullptr;
+    LOG_MODULE("RuleManager", "shutdown", LOG_INFO, "规则计算工作线程已停止");
 }
 
 // ============================================
@@ -73,21 +114,25 @@ std::vector<std::string> RuleManager::get_available_rule_files() const {
 }
 
 void RuleManager::load_rule_file(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    try {
-        auto json = load_json_file(filename);
-        if (!json.contains("rules")) {
-            LOG_MODULE("RuleManager", "load_rule_file", LOG_WARN, "文件缺少 'rules' 字段: " << filename);
-            return;
+    std::vector<std::string> restored;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            auto json = load_json_file(filename);
+            if (!json.contains("rules")) {
+                LOG_MODULE("RuleManager", "load_rule_file", LOG_WARN, "文件缺少 'rules' 字段: " << filename);
+                return;
+            }
+            restored = parse_config(json["rules"]);
+            current_file_ = filename;
+            LOG_MODULE("RuleManager", "load_rule_file", LOG_INFO, "已加载规则文件: " << filename);
+        }
+        catch (const std::exception& e) {
+            LOG_MODULE("RuleManager", "load_rule_file", LOG_ERROR, "加载失败: " << e.what());
+            throw;
         }
-        parse_config(json["rules"]);
-        current_file_ = filename;
-        LOG_MODULE("RuleManager", "load_rule_file", LOG_INFO, "已加载规则文件: " << filename);
-    }
-    catch (const std::exception& e) {
-        LOG_MODULE("RuleManager", "load_rule_file", LOG_ERROR, "加载失败: " << e.what());
-        throw;
     }
+    restore_value_periods(restored);
 }
 
 bool RuleManager::create_rule_file(const std::string& filename, const nlohmann::json& rules_content) {
@@ -123,13 +168,19 @@ bool RuleManager::modify_rule_file(const std::string& filename, const nlohmann::
     catch (...) {
     }
     j["rules"] = rules_content;
-    if (save_json_file(filename, j)) {
+    if (!save_json_file(filename, j)) {
+        return false;
+    }
+    std::vector<std::string> restored;
+    {
+        // 与工作线程的级联计算互斥：重建规则表会替换规则行与结果槽位
+        std::lock_guard<std::mutex> lock(mutex_);
         if (current_file_ == filename) {
-            parse_config(rules_content);
+            restored = parse_config(rules_content);
         }
-        return true;
     }
-    return false;
+    restore_value_periods(restored);
+    return true;
 }
 
 bool RuleManager::delete_rule_file(const std::string& filename) {
@@ -154,34 +205,37 @@ bool RuleManager::delete_rule_file(const std::string& filename) {
 }
 
 bool RuleManager::save_current_rule_file() {
-    if (current_file_.empty()) {
-        LOG_MODULE("RuleManager", "save_current_rule_file", LOG_WARN, "没有当前加载的规则文件");
-        return false;
-    }
+    std::string filename;
     nlohmann::json rules_json;
-    // 按规则序号顺序输出，保证序号稳定
-    for (const auto& [index, name] : index_to_name_) {
-        auto it = rules_.find(name);
-        if (it == rules_.end()) {
-            continue;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_file_.empty()) {
+            LOG_MODULE("RuleManager", "save_current_rule_file", LOG_WARN, "没有当前加载的规则文件");
+            return false;
         }
-        const Rule& rule = it->second;
-        nlohmann::json parents_json = nlohmann::json::array();
-        for (const auto& parent : rule.get_parents()) {
-            if (parent.type == ParentType::CHANNEL) {
-                parents_json.push_back(parent.channel);
-            }
-            else if (parent.type == ParentType::RULE) {
-                parents_json.push_back(parent.rule_index);
+        filename = current_file_;
+        // 按规则序号顺序输出，保证序号稳定
+        for (int index = 1; index <= static_cast<int>(table_.size()); ++index) {
+            const Rule& rule = table_.rule(index);
+            const std::string& name = rule.get_name();
+            nlohmann::json parents_json = nlohmann::json::array();
+            for (const auto& parent : rule.get_parents()) {
+                if (parent.type == ParentType::CHANNEL) {
+                    parents_json.push_back(parent.channel);
+                }
+                else if (parent.type == ParentType::RULE) {
+                    parents_json.push_back(parent.rule_index);
+                }
             }
+            rules_json[name] = {
+                {"enabled", rule.get_enabled()},
+                {"parents", parents_json},
+                {"mode", rule.get_mode()},
+                {"valuePattern", rule.get_value_pattern()}};
         }
-        rules_json[name] = {
-            {"enabled", rule.get_enabled()},
-            {"parents", parents_json},
-            {"mode", rule.get_mode()},
-            {"valuePattern", rule.get_value_pattern()}};
     }
-    return modify_rule_file(current_file_, rules_json);
+    // modify_rule_file 自行加锁，此处须先释放 mutex_
+    return modify_rule_file(filename, rules_json);
 }
 
 // ============================================
@@ -199,17 +253,21 @@ void RuleManager::load_rules(std::shared_ptr<ConfigManager> config_manager) {
 }
 
 void RuleManager::reload_rules() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!config_manager_) {
-        LOG_MODULE("RuleManager", "reload_rules", LOG_WARN, "ConfigManager 未初始化");
-        return;
-    }
-    auto rules_json = config_manager_->get<nlohmann::json>("rules");
-    if (!rules_json.has_value()) {
-        LOG_MODULE("RuleManager", "reload_rules", LOG_WARN, "配置中没有 'rules' 字段");
-        return;
+    std::vector<std::string> restored;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!config_manager_) {
+            LOG_MODULE("RuleManager", "reload_rules", LOG_WARN, "ConfigManager 未初始化");
+            return;
+        }
+        auto rules_json = config_manager_->get<nlohmann::json>("rules");
+        if (!rules_json.has_value()) {
+            LOG_MODULE("RuleManager", "reload_rules", LOG_WARN, "配置中没有 'rules' 字段");
+            return;
+        }
+        restored = parse_config(rules_json.value());
     }
-    parse_config(rules_json.value());
+    restore_value_periods(restored);
 }
 
 // ============================================
@@ -217,42 +275,41 @@ void RuleManager::reload_rules() {
 // ============================================
 
 std::vector<std::string> RuleManager::get_rule_names() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto snapshot = load_snapshot();
+    const RuleTable& table = snapshot->table;
     std::vector<std::string> names;
-    names.reserve(index_to_name_.size());
-    for (const auto& [index, name] : index_to_name_) {
-        names.push_back(name);
+    names.reserve(table.size());
+    for (int index = 1; index <= static_cast<int>(table.size()); ++index) {
+        names.push_back(table.name(index));
     }
     return names;
 }
 
 std::string RuleManager::get_rule_display_string(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() ? it->second.get_display_string() : "";
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 ? snapshot->table.rule(index).get_display_string() : "";
 }
 
 std::vector<std::string> RuleManager::get_all_rule_display_strings() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto snapshot = load_snapshot();
+    const RuleTable& table = snapshot->table;
     std::vector<std::string> result;
-    result.reserve(rules_.size());
-    for (const auto& [index, name] : index_to_name_) {
-        auto it = rules_.find(name);
-        if (it != rules_.end()) {
-            result.push_back(it->second.get_display_string());
-        }
+    result.reserve(table.size());
+    for (int index = 1; index <= static_cast<int>(table.size()); ++index) {
+        result.push_back(table.rule(index).get_display_string());
     }
     return result;
 }
 
 std::string RuleManager::get_rule_channel(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    if (index < 0) {
         return "";
     }
     // 返回首个通道父级（兼容旧 channel 字段语义）
-    for (const auto& parent : it->second.get_parents()) {
+    for (const auto& parent : snapshot->table.rule(index).get_parents()) {
         if (parent.type == ParentType::CHANNEL) {
             return parent.channel;
         }
@@ -261,54 +318,53 @@ std::string RuleManager::get_rule_channel(const std::string& rule_name) const {
 }
 
 int RuleManager::get_rule_mode(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() ? it->second.get_mode() : -1;
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 ? snapshot->table.mode(index) : -1;
 }
 
 std::string RuleManager::get_rule_value_pattern(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() ? it->second.get_value_pattern() : "";
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 ? snapshot->table.rule(index).get_value_pattern() : "";
 }
 
 int RuleManager::get_rule_index(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() ? it->second.get_index() : -1;
+    return load_snapshot()->table.find(rule_name);
 }
 
 std::string RuleManager::get_rule_name_by_index(int rule_index) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = index_to_name_.find(rule_index);
-    return it != index_to_name_.end() ? it->second : "";
+    auto snapshot = load_snapshot();
+    return snapshot->table.contains(rule_index) ? snapshot->table.name(rule_index) : "";
 }
 
 bool RuleManager::get_rule_enabled(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() && it->second.get_enabled();
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 && snapshot->table.enabled(index);
 }
 
 bool RuleManager::is_rule_effectively_enabled(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<std::string> visiting;
-    return is_rule_effectively_enabled_locked(rule_name, visiting);
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 && static_cast<size_t>(index) < snapshot->effective.size()
+        && snapshot->effective[index];
 }
 
 std::vector<RuleParent> RuleManager::get_rule_parents(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    return it != rules_.end() ? it->second.get_parents() : std::vector<RuleParent>();
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    return index > 0 ? snapshot->table.rule(index).get_parents() : std::vector<RuleParent>();
 }
 
 std::string RuleManager::get_rule_parents_display(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    auto snapshot = load_snapshot();
+    const RuleTable& table = snapshot->table;
+    int index = table.find(rule_name);
+    if (index < 0) {
         return "无";
     }
-    const Rule& rule = it->second;
+    const Rule& rule = table.rule(index);
     // 通道父级（声明）
     std::vector<std::string> channel_parts;
     for (const auto& parent : rule.get_parents()) {
@@ -318,11 +374,8 @@ std::string RuleManager::get_rule_parents_display(const std::string& rule_name)
     }
     // 规则父级（由值模式 {rule:xx} 推导）
     std::vector<std::string> rule_parts;
-    auto ref_it = referrers_.find(rule.get_index());
-    if (ref_it != referrers_.end()) {
-        for (int ref_index : ref_it->second) {
-            rule_parts.push_back("rule:" + std::to_string(ref_index));
-        }
+    for (int ref_index : table.referrers(index)) {
+        rule_parts.push_back("rule:" + std::to_string(ref_index));
     }
     // 组装显示文本：通道在前，规则在后
     std::string result;
@@ -355,12 +408,13 @@ std::string RuleManager::get_rule_parents_display(const std::string& rule_name)
 }
 
 int RuleManager::get_rule_mode_applicability(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    auto snapshot = load_snapshot();
+    const RuleTable& table = snapshot->table;
+    int index = table.find(rule_name);
+    if (index < 0) {
         return 1;
     }
-    const Rule& rule = it->second;
+    const Rule& rule = table.rule(index);
     // 统计通道父级数量
     size_t channel_count = 0;
     for (const auto& parent : rule.get_parents()) {
@@ -369,11 +423,7 @@ int RuleManager::get_rule_mode_applicability(const std::string& rule_name) const
         }
     }
     // 统计规则父级数量（由值模式 {rule:xx} 推导）
-    size_t rule_count = 0;
-    auto ref_it = referrers_.find(rule.get_index());
-    if (ref_it != referrers_.end()) {
-        rule_count = ref_it->second.size();
-    }
+    size_t rule_count = table.referrers(index).size();
     if (channel_count > 0 && rule_count == 0) {
         return 0;
     }
@@ -384,13 +434,12 @@ int RuleManager::get_rule_mode_applicability(const std::string& rule_name) const
 }
 
 std::optional<int> RuleManager::get_rule_last_result(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    if (index < 0 || static_cast<size_t>(index) >= snapshot->results->size()) {
         return std::nullopt;
     }
-    auto lit = last_results_.find(it->second.get_index());
-    return lit != last_results_.end() ? lit->second : std::nullopt;
+    return (*snapshot->results)[index].load();
 }
 
 // ============================================
@@ -398,28 +447,33 @@ std::optional<int> RuleManager::get_rule_last_result(const std::string& rule_nam
 // ============================================
 
 void RuleManager::set_rule_enabled(const std::string& rule_name, bool enabled) {
+    std::vector<std::string> restored;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end()) {
+        int index = table_.find(rule_name);
+        if (index < 0) {
             return;
         }
-        it->second.set_enabled(enabled);
+        table_.set_enabled(index, enabled);
+        restored = refresh_effective_locked({ index });
+        publish_snapshot_locked();
     }
+    restore_value_periods(restored);
     emit rules_changed();
 }
 
 void RuleManager::set_rule_channel(const std::string& rule_name, const std::string& channel) {
+    std::vector<std::string> restored;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         std::string ch = Rule::normalize_channel(channel);
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end()) {
+        int index = table_.find(rule_name);
+        if (index < 0) {
             return;
         }
         // 收集新的父级列表（保留非通道父级，替换通道父级）
         std::vector<RuleParent> new_parents;
-        for (const auto& parent : it->second.get_parents()) {
+        for (const auto& parent : table_.rule(index).get_parents()) {
             if (parent.type != ParentType::CHANNEL) {
                 new_parents.push_back(parent);
             }
@@ -430,51 +484,65 @@ void RuleManager::set_rule_channel(const std::string& rule_name, const std::stri
             parent.channel = ch;
             new_parents.push_back(parent);
         }
-        it->second.set_parents(new_parents);
+        // 受影响的规则：本规则与原先声明同通道的规则（去重时可能被清除通道父级）
+        std::vector<int> affected{ index };
+        uint8_t bit = RuleTable::channel_bit(ch);
+        if (bit != 0) {
+            for (int other : table_.channel_rules(bit)) {
+                if (other != index) {
+                    affected.push_back(other);
+                }
+            }
+        }
+        table_.set_parents(index, new_parents);
         // 通道唯一性：保留最后设置的规则，其余声明同通道的规则父级置空
         deduplicate_channel_parents_keep(rule_name, ch);
+        restored = refresh_effective_locked(affected);
+        publish_snapshot_locked();
     }
+    restore_value_periods(restored);
     emit rules_changed();
 }
 
 void RuleManager::set_rule_value_pattern(const std::string& rule_name,
     const std::string& pattern) {
+    std::vector<std::string> restored;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end()) {
+        int index = table_.find(rule_name);
+        if (index < 0) {
             return;
         }
-        // 重建规则对象（保留序号、启用、父级等字段），并刷新引用索引
-        Rule new_rule(rule_name, it->second.get_channel(), it->second.get_mode(), pattern,
-            it->second.get_enabled(), it->second.get_parents(), it->second.get_index());
-        it->second = std::move(new_rule);
-        rebuild_indexes();
+        // 重建规则对象并按差量更新引用索引（仅作废本规则及下游的缓存结果）
+        restored = update_rule_pattern_locked(index, pattern);
+        publish_snapshot_locked();
     }
+    restore_value_periods(restored);
     emit rules_changed();
     LOG_MODULE("RuleManager", "set_rule_value_pattern", LOG_DEBUG,
         "规则 " << rule_name << " 值模式已更新: " << pattern);
 }
 
 std::vector<int> RuleManager::get_rule_parent_rules(const std::string& rule_name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
+    auto snapshot = load_snapshot();
+    int index = snapshot->table.find(rule_name);
+    if (index < 0) {
         return {};
     }
     // 规则父级由值模式 {rule:xx} 推导（referrers 反向索引）
-    auto ref_it = referrers_.find(it->second.get_index());
-    return ref_it != referrers_.end() ? ref_it->second : std::vector<int>();
+    return snapshot->table.referrers(index);
 }
 
 bool RuleManager::add_rule_reference(const std::string& rule_name, int referenced_index) {
+    std::vector<std::string> restored;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end() || referenced_index <= 0) {
+        int index = table_.find(rule_name);
+        if (index < 0 || referenced_index <= 0) {
             return false;
         }
-        std::string pattern = it->second.get_value_pattern();
+        const Rule& old_rule = table_.rule(index);
+        std::string pattern = old_rule.get_value_pattern();
         std::string token = "{rule:" + std::to_string(referenced_index) + "}";
         if (pattern.find(token) != std::string::npos) {
             return false;
@@ -486,24 +554,25 @@ bool RuleManager::add_rule_reference(const std::string& rule_name, int reference
         else {
             pattern += "+" + token;
         }
-        // 重建规则对象（保留其他字段），并刷新索引
-        Rule new_rule(rule_name, it->second.get_channel(), it->second.get_mode(), pattern,
-            it->second.get_enabled(), it->second.get_parents(), it->second.get_index());
-        it->second = std::move(new_rule);
-        rebuild_indexes();
+        // 重建规则对象并按差量更新引用索引
+        restored = update_rule_pattern_locked(index, pattern);
+        publish_snapshot_locked();
     }
+    restore_value_periods(restored);
     emit rules_changed();
     return true;
 }
 
 bool RuleManager::remove_rule_reference(const std::string& rule_name, int referenced_index) {
+    std::vector<std::string> restored;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end() || referenced_index <= 0) {
+        int index = table_.find(rule_name);
+        if (index < 0 || referenced_index <= 0) {
             return false;
         }
-        std::string pattern = it->second.get_value_pattern();
+        const Rule& old_rule = table_.rule(index);
+        std::string pattern = old_rule.get_value_pattern();
         std::string token = "{rule:" + std::to_string(referenced_index) + "}";
         if (pattern.find(token) == std::string::npos) {
             return false;
@@ -525,12 +594,11 @@ bool RuleManager::remove_rule_reference(const std::string& rule_name, int refere
                 || cleaned.back() == '*' || cleaned.back() == '/')) {
             cleaned.pop_back();
         }
-        // 重建规则对象（保留其他字段），并刷新索引
-        Rule new_rule(rule_name, it->second.get_channel(), it->second.get_mode(), cleaned,
-            it->second.get_enabled(), it->second.get_parents(), it->second.get_index());
-        it->second = std::move(new_rule);
-        rebuild_indexes();
+        // 重建规则对象并按差量更新引用索引
+        restored = update_rule_pattern_locked(index, cleaned);
+        publish_snapshot_locked();
     }
+    restore_value_periods(restored);
     emit rules_changed();
     return true;
 }
@@ -540,104 +608,71 @@ bool RuleManager::remove_rule_reference(const std::string& rule_name, int refere
 // ============================================
 
 void RuleManager::set_channel_enabled(const std::string& channel, bool enabled) {
-    std::vector<QJsonObject> pending_commands;
-    std::vector<ResultEvent> pending_results;
+    std::vector<std::string> restored;
+    uint8_t bit = 0;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         std::string ch = Rule::normalize_channel(channel);
         if (ch.empty()) {
             return;
         }
-        channel_enabled_[ch] = enabled;
-        LOG_MODULE("RuleManager", "set_channel_enabled", LOG_INFO,
-            "通道 " << ch << " 启用状态: " << (enabled ? "启用" : "关闭"));
+        bit = RuleTable::channel_bit(ch);
         if (enabled) {
-            // 通道启用时触发直连该通道的规则计算（整条调用链开始运转）
-            std::vector<std::string> names;
-            for (const auto& [name, rule] : rules_) {
-                if (rule.has_parent_channel(ch)) {
-                    names.push_back(name);
-                }
-            }
-            for (const auto& name : names) {
-                compute_rule_locked(name, pending_commands, pending_results);
-            }
+            channel_enabled_mask_ |= bit;
         }
+        else {
+            channel_enabled_mask_ &= static_cast<uint8_t>(~bit);
+        }
+        LOG_MODULE("RuleManager", "set_channel_enabled", LOG_INFO,
+            "通道 " << ch << " 启用状态: " << (enabled ? "启用" : "关闭"));
+        // 直连该通道的规则及其上游的有效启用位需要重算
+        restored = refresh_effective_locked(table_.channel_rules(bit));
+        publish_snapshot_locked();
     }
-    for (const auto& cmd : pending_commands) {
-        emit rule_command_ready(cmd);
-    }
-    for (const auto& [rule_name, ch, value] : pending_results) {
-        emit rule_result_changed(QString::fromStdString(rule_name),
-            QString::fromStdString(ch), value);
+    restore_value_periods(restored);
+    if (enabled) {
+        // 通道启用时在工作线程触发直连该通道的规则计算（整条调用链开始运转）
+        post_to_worker([this, bit]() { compute_channel_rules(bit); });
     }
 }
 
 bool RuleManager::get_channel_enabled(const std::string& channel) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = channel_enabled_.find(Rule::normalize_channel(channel));
-    return it != channel_enabled_.end() && it->second;
+    uint8_t bit = RuleTable::channel_bit(Rule::normalize_channel(channel));
+    return bit != 0 && (load_snapshot()->channel_enabled_mask & bit) != 0;
 }
 
 // ============================================
 // 计算（public）
 // ============================================
 
-std::optional<int> RuleManager::compute_rule(const std::string& rule_name) {
-    std::vector<QJsonObject> pending_commands;
-    std::vector<ResultEvent> pending_results;
-    std::optional<int> result;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        result = compute_rule_locked(rule_name, pending_commands, pending_results);
-    }
-    // 解锁后统一发送通道命令与结果事件，避免持锁调用外部槽
-    for (const auto& cmd : pending_commands) {
-        emit rule_command_ready(cmd);
-    }
-    for (const auto& [rule_name2, ch, value] : pending_results) {
-        emit rule_result_changed(QString::fromStdString(rule_name2),
-            QString::fromStdString(ch), value);
-    }
-    return result;
+void RuleManager::compute_rule(const std::string& rule_name) {
+    post_to_worker([this, rule_name]() { compute_rule_now(rule_name); });
 }
 
-std::optional<int> RuleManager::trigger_rule(const std::string& rule_name) {
-    std::vector<QJsonObject> pending_commands;
-    std::vector<ResultEvent> pending_results;
-    std::optional<int> result;
+void RuleManager::process_value_changes(const std::vector<std::string>& value_ids) {
+    // 模块数值变化 → 标记引用这些数值的规则为脏，整批按拓扑序每条规则计算一次
+    PropagationWave wave;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        // 手动触发：跳过启用检查直接计算
-        auto it = rules_.find(rule_name);
-        if (it == rules_.end()) {
-            return std::nullopt;
-        }
-        if (compute_depth_ >= MAX_COMPUTE_DEPTH) {
-            LOG_MODULE("RuleManager", "trigger_rule", LOG_WARN,
-                "级联计算深度超限，终止: " << rule_name);
-            return std::nullopt;
-        }
-        ++compute_depth_;
-        std::vector<std::optional<int>> values;
-        values.reserve(it->second.get_placeholders().size());
-        for (const auto& ph : it->second.get_placeholders()) {
-            values.push_back(resolve_placeholder_locked(ph, pending_commands, pending_results));
+        for (const auto& value_id : value_ids) {
+            auto it = id_users_.find(value_id);
+            if (it == id_users_.end()) {
+                continue;
+            }
+            for (int idx : it->second) {
+                mark_dirty_locked(idx, wave);
+            }
         }
-        result = it->second.compute_value(values);
-        --compute_depth_;
-        if (result.has_value()) {
-            last_results_[it->second.get_index()] = result.value();
+        if (wave.dirty.empty()) {
+            return;
         }
+        drain_wave_locked(wave);
     }
-    for (const auto& cmd : pending_commands) {
-        emit rule_command_ready(cmd);
-    }
-    for (const auto& [rule_name2, ch, value] : pending_results) {
-        emit rule_result_changed(QString::fromStdString(rule_name2),
-            QString::fromStdString(ch), value);
-    }
-    return result;
+    emit_wave(wave);
+}
+
+void RuleManager::trigger_rule(const std::string& rule_name) {
+    post_to_worker([this, rule_name]() { trigger_rule_now(rule_name); });
 }
 
 // ============================================
@@ -659,41 +694,29 @@ nlohmann::json RuleManager::load_json_file(const std::string& filename) const {
 // private slots 实现
 // ============================================
 
-void RuleManager::on_module_value_changed(const QString& module_name, const QString& value_id,
-    int new_value) {
-    // 模块数值变化 → 触发值模式中引用该数值的规则计算
-    std::vector<QJsonObject> pending_commands;
-    std::vector<ResultEvent> pending_results;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = id_users_.find(value_id.toStdString());
-        if (it == id_users_.end()) {
-            return;
-        }
-        std::vector<std::string> names;
-        for (int idx : it->second) {
-            auto nit = index_to_name_.find(idx);
-            if (nit != index_to_name_.end()) {
-                names.push_back(nit->second);
-            }
-        }
-        for (const auto& name : names) {
-            std::vector<std::string> visiting;
-            // 仅启用且父级可用的规则参与计算
-            if (is_rule_effectively_enabled_locked(name, visiting)) {
-                compute_rule_locked(name, pending_commands, pending_results);
-            }
-        }
+void RuleManager::on_module_values_changed(const QStringList& value_ids) {
+    std::vector<std::string> ids;
+    ids.reserve(static_cast<size_t>(value_ids.size()));
+    for (const auto& id : value_ids) {
+        ids.push_back(id.toStdString());
     }
-    for (const auto& cmd : pending_commands) {
-        emit rule_command_ready(cmd);
+    if (worker_ == nullptr) {
+        // 工作线程未启动（未初始化或已关闭）时同步计算
+        process_value_changes(ids);
+        return;
     }
-    for (const auto& [rule_name2, ch, value] : pending_results) {
-        emit rule_result_changed(QString::fromStdString(rule_name2),
-            QString::fromStdString(ch), value);
+    input_queue_.push(std::move(ids));
+    // 工作线程尚未排队消费时才投递一次，积压期间的批次由同一次消费合并处理
+    if (!drain_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(worker_, [this]() { drain_input_queue(); }, Qt::QueuedConnection);
     }
 }
 
+void RuleManager::on_module_values_registered() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bind_value_slots_locked();
+}
+
 // ============================================
 // 私有辅助函数实现（private）
 // ============================================
@@ -724,8 +747,9 @@ bool RuleManager::save_json_file(const std::string& filename, const nlohmann::js
     return true;
 }
 
-void RuleManager::parse_config(const nlohmann::json& config) {
-    rules_.clear();
+std::vector<std::string> RuleManager::parse_config(const nlohmann::json& config) {
+    table_.clear();
+    table_.reserve(config.size());
     int index = 1;
     for (auto& [key, value] : config.items()) {
         try {
@@ -777,7 +801,11 @@ void RuleManager::parse_config(const nlohmann::json& config) {
                 continue;
             }
 
-            rules_.emplace(key, Rule(key, channel, mode, value_pattern, enabled, parents, index));
+            if (table_.add(Rule(key, channel, mode, value_pattern, enabled, parents, index)) < 0) {
+                LOG_MODULE("RuleManager", "parse_config", LOG_WARN,
+                    "规则 " << key << " 名称重复，已跳过");
+                continue;
+            }
             ++index;
             LOG_MODULE("RuleManager", "parse_config", LOG_DEBUG,
                 "加载规则: " << key << " [#" << (index - 1)
@@ -791,38 +819,281 @@ void RuleManager::parse_config(const nlohmann::json& config) {
     // 重建索引后执行通道父级唯一性去重
     rebuild_indexes();
     deduplicate_channel_parents();
+    std::vector<std::string> restored = refresh_effective_locked();
+    publish_snapshot_locked();
     emit rules_changed();
+    return restored;
 }
 
 void RuleManager::rebuild_indexes() {
-    index_to_name_.clear();
-    referrers_.clear();
+    table_.clear_referrers();
+    table_.clear_last_results();
+    // 新的结果槽位（旧快照仍持有旧槽位，读取不受影响）
+    result_slots_ = std::make_shared<std::vector<ModuleValueSlot>>(table_.size() + 1);
     id_users_.clear();
-    last_results_.clear();
-    for (const auto& [name, rule] : rules_) {
-        index_to_name_[rule.get_index()] = name;
-        for (const auto& ph : rule.get_placeholders()) {
-            if (ph.type == PlaceholderType::RULE_REF && ph.rule_index > 0) {
-                referrers_[ph.rule_index].push_back(rule.get_index());
+    for (int index = 1; index <= static_cast<int>(table_.size()); ++index) {
+        for (const auto& ph : table_.rule(index).get_placeholders()) {
+            if (ph.type == PlaceholderType::RULE_REF && table_.contains(ph.rule_index)) {
+                table_.add_referrer(ph.rule_index, index);
             }
             else if (ph.type == PlaceholderType::ID_REF && !ph.id.empty()) {
-                id_users_[ph.id].push_back(rule.get_index());
+                id_users_[ph.id].push_back(index);
             }
         }
     }
     // 排序引用列表，保证级联触发顺序稳定
-    for (auto& [key, list] : referrers_) {
-        std::sort(list.begin(), list.end());
-    }
+    table_.sort_referrers();
     for (auto& [key, list] : id_users_) {
         std::sort(list.begin(), list.end());
     }
+    rebuild_topology();
+    bind_value_slots_locked();
+}
+
+void RuleManager::rebuild_topology() {
+    // 迭代 Tarjan：边为 被引用规则 → 引用者，强连通分量按逆拓扑序产出
+    int node_count = static_cast<int>(table_.size()) + 1;
+    topo_order_.clear();
+    topo_order_.reserve(table_.size());
+    topo_rank_.assign(node_count, -1);
+    cyclic_.assign(node_count, false);
+
+    auto successors = [this](int v) -> const std::vector<int>& {
+        return table_.referrers(v);
+    };
+
+    std::vector<int> disc(node_count, -1);
+    std::vector<int> low(node_count, 0);
+    std::vector<bool> on_stack(node_count, false);
+    std::vector<int> scc_stack;
+    std::vector<std::pair<int, size_t>> call_stack;
+    int timer = 0;
+    size_t cycle_count = 0;
+
+    for (int root = 1; root < node_count; ++root) {
+        if (disc[root] != -1) {
+            continue;
+        }
+        disc[root] = low[root] = timer++;
+        scc_stack.push_back(root);
+        on_stack[root] = true;
+        call_stack.emplace_back(root, 0);
+        while (!call_stack.empty()) {
+            int v = call_stack.back().first;
+            size_t& next = call_stack.back().second;
+            const auto& out = successors(v);
+            if (next < out.size()) {
+                int w = out[next++];
+                if (w <= 0 || w >= node_count) {
+                    continue;
+                }
+                if (disc[w] == -1) {
+                    disc[w] = low[w] = timer++;
+                    scc_stack.push_back(w);
+                    on_stack[w] = true;
+                    call_stack.emplace_back(w, 0);
+                }
+                else if (on_stack[w]) {
+                    low[v] = std::min(low[v], disc[w]);
+                }
+                continue;
+            }
+            if (low[v] == disc[v]) {
+                // 弹出一个强连通分量：多于一个节点或自引用即为循环
+                size_t begin = scc_stack.size();
+                do {
+                    --begin;
+                } while (scc_stack[begin] != v);
+                bool is_cycle = scc_stack.size() - begin > 1;
+                if (!is_cycle) {
+                    const auto& self_out = successors(v);
+                    is_cycle = std::find(self_out.begin(), self_out.end(), v) != self_out.end();
+                }
+                for (size_t i = begin; i < scc_stack.size(); ++i) {
+                    int member = scc_stack[i];
+                    on_stack[member] = false;
+                    cyclic_[member] = is_cycle;
+                    topo_order_.push_back(member);
+                }
+                if (is_cycle) {
+                    ++cycle_count;
+                }
+                scc_stack.resize(begin);
+            }
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                int parent = call_stack.back().first;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+    // Tarjan 产出为逆拓扑序，反转后被引用者在前
+    std::reverse(topo_order_.begin(), topo_order_.end());
+    for (size_t i = 0; i < topo_order_.size(); ++i) {
+        topo_rank_[topo_order_[i]] = static_cast<int>(i);
+    }
+    if (cycle_count > 0) {
+        for (int idx : topo_order_) {
+            if (cyclic_[idx]) {
+                LOG_MODULE("RuleManager", "rebuild_topology", LOG_WARN,
+                    "规则 " << table_.name(idx) << " [#" << idx << "] 处于循环引用中，已排除计算");
+            }
+        }
+    }
+}
+
+void RuleManager::bind_value_slots_locked() {
+    size_t bound = 0;
+    size_t unbound = 0;
+    for (int index = 1; index <= static_cast<int>(table_.size()); ++index) {
+        auto [rule_bound, rule_unbound] = bind_rule_value_slots_locked(index);
+        bound += rule_bound;
+        unbound += rule_unbound;
+    }
+    LOG_MODULE("RuleManager", "bind_value_slots_locked", LOG_DEBUG,
+        "数值槽位绑定完成: 已绑定 " << bound << "，未绑定 " << unbound);
+}
+
+std::pair<size_t, size_t> RuleManager::bind_rule_value_slots_locked(int rule_index) {
+    auto& module_manager = ModuleManager::instance();
+    size_t bound = 0;
+    size_t unbound = 0;
+    const auto& placeholders = table_.rule(rule_index).get_placeholders();
+    std::vector<std::shared_ptr<const ModuleValueSlot>> bound_slots(placeholders.size());
+    for (size_t i = 0; i < placeholders.size(); ++i) {
+        if (placeholders[i].type != PlaceholderType::ID_REF) {
+            continue;
+        }
+        bound_slots[i] = module_manager.find_value_slot(placeholders[i].id);
+        if (bound_slots[i]) {
+            ++bound;
+        }
+        else {
+            ++unbound;
+            LOG_MODULE("RuleManager", "bind_rule_value_slots_locked", LOG_DEBUG,
+                "规则 " << table_.name(rule_index) << " 引用的数值 ID 暂不存在: " << placeholders[i].id);
+        }
+    }
+    table_.set_value_slots(rule_index, std::move(bound_slots));
+    return { bound, unbound };
+}
+
+std::vector<std::string> RuleManager::update_rule_pattern_locked(int rule_index, const std::string& pattern) {
+    // 1. 记录旧的出边（被引用规则）与数值 ID 引用
+    std::vector<int> old_deps = table_.dependencies(rule_index);
+    std::vector<std::string> old_ids;
+    for (const auto& ph : table_.rule(rule_index).get_placeholders()) {
+        if (ph.type == PlaceholderType::ID_REF && !ph.id.empty()) {
+            old_ids.push_back(ph.id);
+        }
+    }
+
+    // 2. 重建规则对象（保留序号、启用、父级等字段）
+    const Rule& old_rule = table_.rule(rule_index);
+    table_.replace(rule_index, Rule(old_rule.get_name(), old_rule.get_channel(), old_rule.get_mode(),
+        pattern, old_rule.get_enabled(), old_rule.get_parents(), rule_index));
+
+    // 3. 收集新的出边与数值 ID 引用（排序去重后与旧集合求差）
+    std::vector<int> new_deps;
+    std::vector<std::string> new_ids;
+    for (const auto& ph : table_.rule(rule_index).get_placeholders()) {
+        if (ph.type == PlaceholderType::RULE_REF && table_.contains(ph.rule_index)) {
+            new_deps.push_back(ph.rule_index);
+        }
+        else if (ph.type == PlaceholderType::ID_REF && !ph.id.empty()) {
+            new_ids.push_back(ph.id);
+        }
+    }
+    std::sort(new_deps.begin(), new_deps.end());
+    new_deps.erase(std::unique(new_deps.begin(), new_deps.end()), new_deps.end());
+    for (auto* ids : { &old_ids, &new_ids }) {
+        std::sort(ids->begin(), ids->end());
+        ids->erase(std::unique(ids->begin(), ids->end()), ids->end());
+    }
+    std::vector<int> removed_deps;
+    std::vector<int> added_deps;
+    std::set_difference(old_deps.begin(), old_deps.end(), new_deps.begin(), new_deps.end(),
+        std::back_inserter(removed_deps));
+    std::set_difference(new_deps.begin(), new_deps.end(), old_deps.begin(), old_deps.end(),
+        std::back_inserter(added_deps));
+
+    // 4. 按差量维护引用关系与数值 ID 反向索引
+    for (int dep : removed_deps) {
+        table_.erase_referrer(dep, rule_index);
+    }
+    for (int dep : added_deps) {
+        table_.insert_referrer(dep, rule_index);
+    }
+    for (const auto& id : old_ids) {
+        if (std::binary_search(new_ids.begin(), new_ids.end(), id)) {
+            continue;
+        }
+        auto it = id_users_.find(id);
+        if (it == id_users_.end()) {
+            continue;
+        }
+        auto& users = it->second;
+        users.erase(std::remove(users.begin(), users.end(), rule_index), users.end());
+        if (users.empty()) {
+            id_users_.erase(it);
+        }
+    }
+    for (const auto& id : new_ids) {
+        if (std::binary_search(old_ids.begin(), old_ids.end(), id)) {
+            continue;
+        }
+        auto& users = id_users_[id];
+        users.insert(std::lower_bound(users.begin(), users.end(), rule_index), rule_index);
+    }
+
+    // 5. 拓扑序：删边不破坏拓扑序；仅当新边违反现有顺序（可能成环）或本规则原处于循环中时全量重算
+    bool topology_dirty = cyclic_[rule_index] && (!removed_deps.empty() || !added_deps.empty());
+    for (int dep : added_deps) {
+        if (topo_rank_[dep] >= topo_rank_[rule_index]) {
+            topology_dirty = true;
+            break;
+        }
+    }
+    if (topology_dirty) {
+        rebuild_topology();
+    }
+
+    // 6. 仅重新绑定本规则的数值槽位，仅重算出边变化的规则及其上游的有效启用位
+    bind_rule_value_slots_locked(rule_index);
+    std::vector<int> changed_deps;
+    std::set_union(removed_deps.begin(), removed_deps.end(), added_deps.begin(), added_deps.end(),
+        std::back_inserter(changed_deps));
+    std::vector<std::string> restored;
+    if (!changed_deps.empty()) {
+        restored = refresh_effective_locked(changed_deps);
+    }
+
+    // 7. 仅作废本规则及其下游（引用者闭包）的缓存结果，其余规则的级联状态保留
+    std::vector<int> stack{ rule_index };
+    std::vector<bool> visited(table_.size() + 1, false);
+    while (!stack.empty()) {
+        int idx = stack.back();
+        stack.pop_back();
+        if (visited[idx]) {
+            continue;
+        }
+        visited[idx] = true;
+        set_last_result_locked(idx, std::nullopt);
+        for (int ref : table_.referrers(idx)) {
+            stack.push_back(ref);
+        }
+    }
+    LOG_MODULE("RuleManager", "update_rule_pattern_locked", LOG_DEBUG,
+        "规则 " << table_.name(rule_index) << " 引用关系增量更新: 移除 " << removed_deps.size()
+                << "，新增 " << added_deps.size() << "，拓扑序" << (topology_dirty ? "已重算" : "保持不变"));
+    return restored;
 }
 
 void RuleManager::deduplicate_channel_parents() {
     // 统计每个通道被声明的最小规则序号
     std::map<std::string, int> channel_owner;
-    for (const auto& [name, rule] : rules_) {
+    for (int index = 1; index <= static_cast<int>(table_.size()); ++index) {
+        const Rule& rule = table_.rule(index);
         for (const auto& parent : rule.get_parents()) {
             if (parent.type == ParentType::CHANNEL) {
                 auto it = channel_owner.find(parent.channel);
@@ -833,7 +1104,9 @@ void RuleManager::deduplicate_channel_parents() {
         }
     }
     // 除序号最小的规则外，其余规则的同通道父级移除（父级清空则视为"无"）
-    for (auto& [name, rule] : rules_) {
+    for (int index = 1; index <= static_cast<int>(table_.size()); ++index) {
+        const Rule& rule = table_.rule(index);
+        const std::string& name = rule.get_name();
         std::vector<RuleParent> kept;
         bool changed = false;
         for (const auto& parent : rule.get_parents()) {
@@ -854,7 +1127,7 @@ void RuleManager::deduplicate_channel_parents() {
             }
         }
         if (changed) {
-            rule.set_parents(kept);
+            table_.set_parents(index, kept);
         }
     }
 }
@@ -862,16 +1135,18 @@ void RuleManager::deduplicate_channel_parents() {
 void RuleManager::deduplicate_channel_parents_keep(const std::string& keep_name,
     const std::string& channel) {
     // 手动设置通道时：保留最后设置的规则，其余声明同通道的规则父级移除
-    if (channel.empty()) {
+    uint8_t bit = RuleTable::channel_bit(channel);
+    if (bit == 0) {
         return;
     }
-    for (auto& [name, rule] : rules_) {
+    // set_parents 会修改通道成员列表，遍历其副本
+    std::vector<int> members = table_.channel_rules(bit);
+    for (int index : members) {
+        const Rule& rule = table_.rule(index);
+        const std::string& name = rule.get_name();
         if (name == keep_name) {
             continue;
         }
-        if (!rule.has_parent_channel(channel)) {
-            continue;
-        }
         std::vector<RuleParent> kept;
         for (const auto& parent : rule.get_parents()) {
             if (parent.type == ParentType::CHANNEL && parent.channel == channel) {
@@ -879,171 +1154,389 @@ void RuleManager::deduplicate_channel_parents_keep(const std::string& keep_name,
             }
             kept.push_back(parent);
         }
-        rule.set_parents(kept);
+        // 先记录日志：set_parents 替换规则对象后 name 引用失效
         LOG_MODULE("RuleManager", "deduplicate_channel_parents_keep", LOG_WARN,
             "规则 " << name << " 的通道父级 " << channel << " 被清除（保留 " << keep_name << "）");
+        table_.set_parents(index, kept);
     }
 }
 
-bool RuleManager::is_rule_effectively_enabled_locked(const std::string& rule_name,
-    std::vector<std::string>& visiting) const {
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
-        return false;
+bool RuleManager::is_rule_effectively_enabled_locked(int rule_index) const {
+    return table_.contains(rule_index) && effective_[rule_index];
+}
+
+std::vector<std::string> RuleManager::refresh_effective_locked() {
+    std::vector<int> all(table_.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<int>(i) + 1;
     }
-    const Rule& rule = it->second;
-    if (!rule.get_enabled()) {
-        return false;
+    return refresh_effective_locked(all);
+}
+
+std::vector<std::string> RuleManager::refresh_effective_locked(const std::vector<int>& seeds) {
+    // 有效启用 = 自身启用 且（任一通道父级启用 或 任一引用者有效启用）
+    // 种子变化只影响其自身及上游（被其引用的规则），在该区域内重新求可达性
+    size_t node_count = table_.size() + 1;
+    if (effective_.size() != node_count) {
+        effective_.assign(node_count, false);
+        region_stamp_.assign(node_count, 0);
+        region_epoch_ = 0;
+    }
+    if (++region_epoch_ == 0) {
+        std::fill(region_stamp_.begin(), region_stamp_.end(), 0);
+        region_epoch_ = 1;
+    }
+    // 1. 收集区域：种子及其全部上游
+    std::vector<int> region;
+    std::vector<int> stack;
+    for (int seed : seeds) {
+        if (table_.contains(seed)) {
+            stack.push_back(seed);
+        }
     }
-    // 防循环引用
-    if (std::find(visiting.begin(), visiting.end(), rule_name) != visiting.end()) {
-        return false;
+    while (!stack.empty()) {
+        int idx = stack.back();
+        stack.pop_back();
+        if (region_stamp_[idx] == region_epoch_) {
+            continue;
+        }
+        region_stamp_[idx] = region_epoch_;
+        region.push_back(idx);
+        for (int dep : table_.dependencies(idx)) {
+            stack.push_back(dep);
+        }
     }
-    visiting.push_back(rule_name);
-
-    // 父级 = 通道父级（声明） + 规则父级（值模式引用推导）
-    const auto& parents = rule.get_parents();
-    auto ref_it = referrers_.find(rule.get_index());
-    bool has_parent = !parents.empty() || (ref_it != referrers_.end() && !ref_it->second.empty());
-    if (!has_parent) {
-        visiting.pop_back();
-        return false;
+    // 2. 区域内清零（记录原有效位，用于找出新启用的规则），再以“通道可用”或“区域外引用者有效”的规则为起点
+    std::vector<bool> was_effective(region.size());
+    for (size_t i = 0; i < region.size(); ++i) {
+        was_effective[i] = effective_[region[i]];
+        effective_[region[i]] = false;
     }
-    // 任一通道父级启用 → 启用
-    for (const auto& parent : parents) {
-        if (parent.type == ParentType::CHANNEL) {
-            auto cit = channel_enabled_.find(parent.channel);
-            if (cit != channel_enabled_.end() && cit->second) {
-                visiting.pop_back();
-                return true;
+    std::vector<int> queue;
+    for (int idx : region) {
+        if (!table_.enabled(idx)) {
+            continue;
+        }
+        bool source = (table_.channel_mask(idx) & channel_enabled_mask_) != 0;
+        if (!source) {
+            for (int ref : table_.referrers(idx)) {
+                if (region_stamp_[ref] != region_epoch_ && effective_[ref]) {
+                    source = true;
+                    break;
+                }
+            }
+        }
+        if (source) {
+            effective_[idx] = true;
+            queue.push_back(idx);
+        }
+    }
+    // 3. 沿引用关系向上游传播（仅经过已启用的规则）
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (int dep : table_.dependencies(queue[head])) {
+            if (region_stamp_[dep] == region_epoch_ && !effective_[dep] && table_.enabled(dep)) {
+                effective_[dep] = true;
+                queue.push_back(dep);
             }
         }
     }
-    // 任一规则父级启用 → 启用（递归判定）
-    if (ref_it != referrers_.end()) {
-        for (int ref_index : ref_it->second) {
-            auto nit = index_to_name_.find(ref_index);
-            if (nit != index_to_name_.end()
-                && is_rule_effectively_enabled_locked(nit->second, visiting)) {
-                visiting.pop_back();
-                return true;
+    // 4. 收集新启用的规则引用的数值，由调用方解锁后恢复最快查询周期（自适应轮询可能已将其退避）
+    std::vector<std::string> value_ids;
+    for (size_t i = 0; i < region.size(); ++i) {
+        if (!effective_[region[i]] || was_effective[i]) {
+            continue;
+        }
+        for (const auto& ph : table_.rule(region[i]).get_placeholders()) {
+            if (ph.type == PlaceholderType::ID_REF && !ph.id.empty()) {
+                value_ids.push_back(ph.id);
             }
         }
     }
-    visiting.pop_back();
-    return false;
+    return value_ids;
 }
 
-std::optional<int> RuleManager::compute_rule_locked(const std::string& rule_name,
-    std::vector<QJsonObject>& pending_commands, std::vector<ResultEvent>& pending_results) {
-    auto it = rules_.find(rule_name);
-    if (it == rules_.end()) {
-        return std::nullopt;
+void RuleManager::restore_value_periods(const std::vector<std::string>& value_ids) const {
+    if (!value_ids.empty()) {
+        ModuleManager::instance().reset_adaptive_periods(value_ids);
     }
-    Rule& rule = it->second;
+}
+
+void RuleManager::mark_dirty_locked(int rule_index, PropagationWave& wave) const {
+    if (!table_.contains(rule_index) || topo_rank_[rule_index] < 0) {
+        return;
+    }
+    if (wave.state.empty()) {
+        wave.state.assign(topo_rank_.size(), 0);
+        wave.computed.assign(topo_rank_.size(), std::nullopt);
+    }
+    // 显式栈：连带标记尚无缓存结果的上游规则，使其在本波次中先于下游计算
+    std::vector<int> stack{ rule_index };
+    while (!stack.empty()) {
+        int idx = stack.back();
+        stack.pop_back();
+        if (wave.state[idx] != 0 || cyclic_[idx]) {
+            continue;
+        }
+        wave.state[idx] = 1;
+        wave.dirty.emplace(topo_rank_[idx], idx);
+        for (const auto& ph : table_.rule(idx).get_placeholders()) {
+            if (ph.type == PlaceholderType::RULE_REF && table_.contains(ph.rule_index)
+                && !table_.last_result(ph.rule_index).has_value()) {
+                stack.push_back(ph.rule_index);
+            }
+        }
+    }
+}
+
+void RuleManager::drain_wave_locked(PropagationWave& wave) {
+    while (!wave.dirty.empty()) {
+        int idx = wave.dirty.top().second;
+        wave.dirty.pop();
+        if (wave.state[idx] == 2) {
+            continue;
+        }
+        wave.state[idx] = 2;
+        wave.computed[idx] = evaluate_rule_locked(idx, wave);
+    }
+}
+
+std::optional<int> RuleManager::evaluate_rule_locked(int rule_index, PropagationWave& wave) {
+    const Rule& rule = table_.rule(rule_index);
+    const std::string& rule_name = rule.get_name();
 
     // 有效启用检查（父级可用才参与计算）
-    std::vector<std::string> visiting;
-    if (!is_rule_effectively_enabled_locked(rule_name, visiting)) {
-        LOG_MODULE("RuleManager", "compute_rule_locked", LOG_DEBUG,
+    if (!is_rule_effectively_enabled_locked(rule_index)) {
+        LOG_MODULE("RuleManager", "evaluate_rule_locked", LOG_DEBUG,
             "规则 " << rule_name << " 未启用，跳过计算");
         return std::nullopt;
     }
-    // 级联深度保护（防循环引用导致无限递归）
-    if (compute_depth_ >= MAX_COMPUTE_DEPTH) {
-        LOG_MODULE("RuleManager", "compute_rule_locked", LOG_WARN,
-            "级联计算深度超限，终止: " << rule_name);
+    // 循环引用中的规则不参与计算（加载时已告警）
+    if (cyclic_[rule_index]) {
+        LOG_MODULE("RuleManager", "evaluate_rule_locked", LOG_DEBUG,
+            "规则 " << rule_name << " 处于循环引用中，跳过计算");
         return std::nullopt;
     }
 
-    ++compute_depth_;
-    std::vector<std::optional<int>> values;
-    values.reserve(rule.get_placeholders().size());
-    for (const auto& ph : rule.get_placeholders()) {
-        values.push_back(resolve_placeholder_locked(ph, pending_commands, pending_results));
-    }
-    std::optional<int> result = rule.compute_value(values);
-    --compute_depth_;
-
+    std::optional<int> result = compute_values_locked(rule_index);
     if (!result.has_value()) {
         // 存在空值占位符：本次计算被忽略（不推送、不发送）
-        LOG_MODULE("RuleManager", "compute_rule_locked", LOG_DEBUG,
+        LOG_MODULE("RuleManager", "evaluate_rule_locked", LOG_DEBUG,
             "规则 " << rule_name << " 存在空值，本次计算被忽略");
         return std::nullopt;
     }
 
     // 缓存计算结果
-    last_results_[rule.get_index()] = result.value();
-    LOG_MODULE("RuleManager", "compute_rule_locked", LOG_DEBUG,
+    set_last_result_locked(rule_index, result);
+    LOG_MODULE("RuleManager", "evaluate_rule_locked", LOG_DEBUG,
         "规则 " << rule_name << " 计算结果: " << result.value());
 
-    // 级联推送：结果推送给所有引用本规则的规则（其父级包含本规则）
-    auto ref_it = referrers_.find(rule.get_index());
-    if (ref_it != referrers_.end()) {
-        for (int ref_index : ref_it->second) {
-            auto nit = index_to_name_.find(ref_index);
-            if (nit == index_to_name_.end()) {
-                continue;
-            }
-            std::vector<std::string> v2;
-            // 接收推送的父级若启用且为规则则同样触发计算
-            if (is_rule_effectively_enabled_locked(nit->second, v2)) {
-                compute_rule_locked(nit->second, pending_commands, pending_results);
-            }
-        }
+    // 级联推送：引用本规则的规则标记为脏（拓扑序靠后，本波次稍后计算，每条仅一次）
+    for (int ref_index : table_.referrers(rule_index)) {
+        mark_dirty_locked(ref_index, wave);
     }
 
     // 通道父级：通过调用函数将结果发送给 Python 端
-    for (const auto& parent : rule.get_parents()) {
-        if (parent.type != ParentType::CHANNEL) {
+    uint8_t mask = table_.channel_mask(rule_index);
+    for (uint8_t bit : { RuleTable::CHANNEL_A, RuleTable::CHANNEL_B }) {
+        if (!(mask & bit)) {
             continue;
         }
+        std::string channel = bit == RuleTable::CHANNEL_A ? "A" : "B";
         QJsonObject cmd;
         cmd["cmd"] = "send_strength";
-        cmd["channel"] = QString::fromStdString(parent.channel);
-        cmd["mode"] = rule.get_mode();
+        cmd["channel"] = QString::fromStdString(channel);
+        cmd["mode"] = table_.mode(rule_index);
         cmd["value"] = result.value();
-        pending_commands.push_back(cmd);
+        // 同一波次内每通道只保留最后一条命令
+        wave.channel_commands[bit == RuleTable::CHANNEL_A ? 0 : 1] = cmd;
         // 记录结果事件（首页通道规则卡片刷新用）
-        pending_results.emplace_back(rule_name, parent.channel, result.value());
+        wave.pending_results.emplace_back(rule_name, channel, result.value());
+    }
+    return result;
+}
+
+std::optional<int> RuleManager::compute_values_locked(int rule_index) const {
+    const Rule& rule = table_.rule(rule_index);
+    const auto& placeholders = rule.get_placeholders();
+    const auto& bound_slots = table_.value_slots(rule_index);
+    std::vector<std::optional<int>> values;
+    values.reserve(placeholders.size());
+    for (size_t i = 0; i < placeholders.size(); ++i) {
+        values.push_back(resolve_placeholder_locked(placeholders[i],
+            i < bound_slots.size() ? bound_slots[i].get() : nullptr));
     }
-    return result.value();
+    return rule.compute_value(values);
 }
 
 std::optional<int> RuleManager::resolve_placeholder_locked(const Placeholder& placeholder,
-    std::vector<QJsonObject>& pending_commands, std::vector<ResultEvent>& pending_results) {
+    const ModuleValueSlot* slot) const {
     if (placeholder.type == PlaceholderType::ID_REF) {
-        // 通过模块管理器查询数值（计算时通过查询模块获取对应数值）
-        auto& module_manager = ModuleManager::instance();
-        std::string module_name = module_manager.find_module_by_value_id(placeholder.id);
-        if (module_name.empty()) {
-            LOG_MODULE("RuleManager", "resolve_placeholder_locked", LOG_WARN,
-                "数值 ID 不存在: " << placeholder.id);
-            return std::nullopt;
-        }
-        // 数值尚未获取到（无数据源/未接入真实数据）时视为空值，忽略该项
-        const ModuleValue* value = module_manager.get_value(module_name, placeholder.id);
-        if (!value || !value->get_has_value()) {
-            LOG_MODULE("RuleManager", "resolve_placeholder_locked", LOG_DEBUG,
-                "数值 " << placeholder.id << " 无数据，按空值处理");
-            return std::nullopt;
-        }
-        return module_manager.query_value(module_name, placeholder.id);
+        // 读取预绑定的数值槽位（无锁），数值 ID 不存在或尚未获取到数据时视为空值，忽略该项
+        return slot ? slot->load() : std::nullopt;
     }
     if (placeholder.type == PlaceholderType::RULE_REF) {
-        auto nit = index_to_name_.find(placeholder.rule_index);
-        if (nit == index_to_name_.end()) {
+        if (!table_.contains(placeholder.rule_index)) {
             LOG_MODULE("RuleManager", "resolve_placeholder_locked", LOG_WARN,
                 "规则序号不存在: " << placeholder.rule_index);
             return std::nullopt;
         }
-        // 优先使用缓存结果，未计算过则递归计算（级联触发）
-        auto lit = last_results_.find(placeholder.rule_index);
-        if (lit != last_results_.end() && lit->second.has_value()) {
-            return lit->second.value();
-        }
-        return compute_rule_locked(nit->second, pending_commands, pending_results);
+        // 拓扑序保证上游规则（若为脏）已在本波次先行计算，此处直接取缓存
+        return table_.last_result(placeholder.rule_index);
     }
     // EXTERNAL 占位符（{}）：无外部参数来源，视为空值（忽略该项）
     return std::nullopt;
-}
\ No newline at end of file
+}
+
+void RuleManager::emit_wave(const PropagationWave& wave) {
+    // 命令直接发出（跨线程时由 Qt 排队到接收者线程），不做节流
+    for (const auto& cmd : wave.channel_commands) {
+        if (cmd.has_value()) {
+            emit rule_command_ready(cmd.value());
+        }
+    }
+    if (wave.pending_results.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        for (const auto& [rule_name, ch, value] : wave.pending_results) {
+            pending_ui_results_[{ rule_name, ch }] = value;
+        }
+    }
+    // 结果事件仅用于界面刷新：合并到下一次定时发送，同一规则只保留最新值
+    if (!ui_flush_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() {
+            QTimer::singleShot(UI_FLUSH_INTERVAL_MS, this, [this]() { flush_ui_results(); });
+        }, Qt::QueuedConnection);
+    }
+}
+
+void RuleManager::drain_input_queue() {
+    // 先清除排队标志再消费：消费期间新到的批次会重新投递，不会遗漏
+    drain_scheduled_.store(false, std::memory_order_release);
+    std::vector<std::string> ids;
+    while (auto batch = input_queue_.try_pop()) {
+        ids.insert(ids.end(), std::make_move_iterator(batch->begin()),
+            std::make_move_iterator(batch->end()));
+    }
+    if (ids.empty()) {
+        return;
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    process_value_changes(ids);
+}
+
+void RuleManager::post_to_worker(std::function<void()> task) {
+    if (worker_ == nullptr) {
+        // 工作线程未启动（未初始化或已关闭）时同步计算
+        task();
+        return;
+    }
+    QMetaObject::invokeMethod(worker_, std::move(task), Qt::QueuedConnection);
+}
+
+void RuleManager::compute_rule_now(const std::string& rule_name) {
+    PropagationWave wave;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int index = table_.find(rule_name);
+        if (index < 0) {
+            return;
+        }
+        mark_dirty_locked(index, wave);
+        drain_wave_locked(wave);
+    }
+    // 解锁后统一发送通道命令与结果事件，避免持锁调用外部槽
+    emit_wave(wave);
+}
+
+void RuleManager::trigger_rule_now(const std::string& rule_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 手动触发：跳过启用检查直接计算
+    int index = table_.find(rule_name);
+    if (index < 0) {
+        return;
+    }
+    if (cyclic_[index]) {
+        LOG_MODULE("RuleManager", "trigger_rule", LOG_WARN,
+            "规则 " << rule_name << " 处于循环引用中，跳过计算");
+        return;
+    }
+    // 先按拓扑序计算未缓存结果的上游规则：只缓存结果，不级联下游、不发送通道命令
+    PropagationWave wave;
+    mark_dirty_locked(index, wave);
+    while (!wave.dirty.empty()) {
+        int idx = wave.dirty.top().second;
+        wave.dirty.pop();
+        if (idx == index || !is_rule_effectively_enabled_locked(idx)) {
+            continue;
+        }
+        std::optional<int> upstream = compute_values_locked(idx);
+        if (upstream.has_value()) {
+            set_last_result_locked(idx, upstream);
+        }
+    }
+    std::optional<int> result = compute_values_locked(index);
+    if (result.has_value()) {
+        set_last_result_locked(index, result);
+    }
+}
+
+void RuleManager::compute_channel_rules(uint8_t bit) {
+    PropagationWave wave;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 投递后通道可能已被再次关闭，以计算时的启用状态为准
+        if (!(channel_enabled_mask_ & bit)) {
+            return;
+        }
+        for (int index : table_.channel_rules(bit)) {
+            mark_dirty_locked(index, wave);
+        }
+        drain_wave_locked(wave);
+    }
+    emit_wave(wave);
+}
+
+void RuleManager::flush_ui_results() {
+    std::map<std::pair<std::string, std::string>, int> results;
+    {
+        // 标志在锁内清除：之后写入的结果必定重新安排发送
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        results.swap(pending_ui_results_);
+        ui_flush_scheduled_.store(false, std::memory_order_release);
+    }
+    for (const auto& [key, value] : results) {
+        emit rule_result_changed(QString::fromStdString(key.first),
+            QString::fromStdString(key.second), value);
+    }
+}
+
+void RuleManager::set_last_result_locked(int rule_index, std::optional<int> value) {
+    table_.set_last_result(rule_index, value);
+    if (static_cast<size_t>(rule_index) < result_slots_->size()) {
+        if (value.has_value()) {
+            (*result_slots_)[rule_index].store(value.value());
+        }
+        else {
+            (*result_slots_)[rule_index].clear();
+        }
+    }
+}
+
+std::shared_ptr<const RuleManager::RuleSnapshot> RuleManager::load_snapshot() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+}
+
+void RuleManager::publish_snapshot_locked() {
+    // 规则表按列共享（写时复制，不复制规则对象），启用状态复制后生成新快照，原子替换；正在读取旧快照的线程不受影响
+    auto snapshot = std::make_shared<RuleSnapshot>();
+    snapshot->version = ++snapshot_version_;
+    snapshot->table = table_;
+    snapshot->effective = effective_;
+    snapshot->channel_enabled_mask = channel_enabled_mask_;
+    snapshot->results = result_slots_;
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const RuleSnapshot>(std::move(snapshot)),
+        std::memory_order_release);
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 CrimsonSeraph(ltyy.leoyu@gmail.com)
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include "RuleTable.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+// 有序列表插入（已存在则忽略）
+void sorted_insert(std::vector<int>& list, int value) {
+    auto it = std::lower_bound(list.begin(), list.end(), value);
+    if (it == list.end() || *it != value) {
+        list.insert(it, value);
+    }
+}
+
+// 有序列表删除（不存在则忽略）
+void sorted_erase(std::vector<int>& list, int value) {
+    auto it = std::lower_bound(list.begin(), list.end(), value);
+    if (it != list.end() && *it == value) {
+        list.erase(it);
+    }
+}
+} // namespace
+
+// ============================================
+// 容量与查找（public）
+// ============================================
+
+void RuleTable::clear() {
+    // 换用新的空列，仍被快照共享的旧列不受影响
+    rules_.reset();
+    enabled_.reset();
+    modes_.reset();
+    channel_masks_.reset();
+    channel_rules_.reset();
+    referrers_.reset();
+    dependencies_.reset();
+    last_results_.reset();
+    value_slots_.reset();
+    name_to_index_.reset();
+}
+
+void RuleTable::reserve(size_t count) {
+    rules_.mut().reserve(count);
+    enabled_.mut().reserve(count);
+    modes_.mut().reserve(count);
+    channel_masks_.mut().reserve(count);
+    referrers_.mut().reserve(count);
+    dependencies_.mut().reserve(count);
+    last_results_.mut().reserve(count);
+    value_slots_.mut().reserve(count);
+    name_to_index_.mut().reserve(count);
+}
+
+int RuleTable::add(Rule rule) {
+    int index = static_cast<int>(size()) + 1;
+    if (rule.get_index() != index || name_to_index_.get().count(rule.get_name()) > 0) {
+        return -1;
+    }
+    name_to_index_.mut().emplace(rule.get_name(), index);
+    enabled_.mut().push_back(rule.get_enabled() ? 1 : 0);
+    modes_.mut().push_back(rule.get_mode());
+    channel_masks_.mut().push_back(0);
+    update_channel_mask(index, channel_mask_of(rule.get_parents()));
+    referrers_.mut().emplace_back();
+    dependencies_.mut().emplace_back();
+    last_results_.mut().emplace_back();
+    value_slots_.mut().emplace_back();
+    rules_.mut().push_back(std::make_shared<const Rule>(std::move(rule)));
+    return index;
+}
+
+int RuleTable::find(const std::string& name) const {
+    const auto& names = name_to_index_.get();
+    auto it = names.find(name);
+    return it != names.end() ? it->second : -1;
+}
+
+// ============================================
+// 修改（public）
+// ============================================
+
+void RuleTable::set_enabled(int rule_index, bool enabled) {
+    // 规则对象不可变（可能被快照共享）：复制该行后修改再替换
+    auto& row = rules_.mut()[rule_index - 1];
+    auto updated = std::make_shared<Rule>(*row);
+    updated->set_enabled(enabled);
+    row = std::move(updated);
+    enabled_.mut()[rule_index - 1] = enabled ? 1 : 0;
+}
+
+void RuleTable::set_parents(int rule_index, const std::vector<RuleParent>& parents) {
+    auto& row = rules_.mut()[rule_index - 1];
+    auto updated = std::make_shared<Rule>(*row);
+    updated->set_parents(parents);
+    row = std::move(updated);
+    update_channel_mask(rule_index, channel_mask_of(parents));
+}
+
+void RuleTable::replace(int rule_index, Rule rule) {
+    size_t slot = static_cast<size_t>(rule_index - 1);
+    enabled_.mut()[slot] = rule.get_enabled() ? 1 : 0;
+    modes_.mut()[slot] = rule.get_mode();
+    update_channel_mask(rule_index, channel_mask_of(rule.get_parents()));
+    // 占位符可能已变化，槽位需由调用方重新绑定
+    value_slots_.mut()[slot].clear();
+    rules_.mut()[slot] = std::make_shared<const Rule>(std::move(rule));
+}
+
+void RuleTable::clear_last_results() {
+    last_results_.reset();
+    last_results_.mut().resize(size());
+}
+
+void RuleTable::clear_referrers() {
+    referrers_.reset();
+    referrers_.mut().resize(size());
+    dependencies_.reset();
+    dependencies_.mut().resize(size());
+}
+
+void RuleTable::sort_referrers() {
+    // 同一规则可在值模式中多次引用同一规则，排序后去重
+    for (auto* lists : { &referrers_, &dependencies_ }) {
+        for (auto& list : lists->mut()) {
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+        }
+    }
+}
+
+void RuleTable::insert_referrer(int rule_index, int referrer) {
+    sorted_insert(referrers_.mut()[rule_index - 1], referrer);
+    sorted_insert(dependencies_.mut()[referrer - 1], rule_index);
+}
+
+void RuleTable::erase_referrer(int rule_index, int referrer) {
+    sorted_erase(referrers_.mut()[rule_index - 1], referrer);
+    sorted_erase(dependencies_.mut()[referrer - 1], rule_index);
+}
+
+// ============================================
+// 静态工具（public）
+// ============================================
+
+uint8_t RuleTable::channel_bit(const std::string& channel) {
+    if (channel == "A") {
+        return CHANNEL_A;
+    }
+    if (channel == "B") {
+        return CHANNEL_B;
+    }
+    return 0;
+}
+
+uint8_t RuleTable::channel_mask_of(const std::vector<RuleParent>& parents) {
+    uint8_t mask = 0;
+    for (const auto& parent : parents) {
+        if (parent.type == ParentType::CHANNEL) {
+            mask |= channel_bit(parent.channel);
+        }
+    }
+    return mask;
+}
+
+// ============================================
+// 私有辅助函数（private）
+// ============================================
+
+void RuleTable::update_channel_mask(int rule_index, uint8_t mask) {
+    // 未变化时不写入，避免复制被快照共享的列
+    uint8_t current = channel_masks_.get()[rule_index - 1];
+    if (current == mask) {
+        return;
+    }
+    for (uint8_t bit : { CHANNEL_A, CHANNEL_B }) {
+        if (((mask ^ current) & bit) == 0) {
+            continue;
+        }
+        auto& list = channel_rules_.mut()[bit == CHANNEL_B ? 1 : 0];
+        if (mask & bit) {
+            sorted_insert(list, rule_index);
+        }
+        else {
+            sorted_erase(list, rule_index);
+        }
+    }
+    channel_masks_.mut()[rule_index - 1] = mask;
+}
@@ -11,6 +11,7 @@
 #include "DebugLog.h"
 #include "EditableLabel.h"
 #include "FormulaBuilderDialog.h"
+#include "GsiListener.h"
 #include "IpSelector.h"
 #include "LogExportSettingsDialog.h"
 #include "ModuleManager.h"
@@ -19,6 +20,7 @@
 #include "PythonSubprocessManager.h"
 #include "RuleManager.h"
 #include "SampledWaveformWidget.h"
+#include "ShmRingSource.h"
 #include "StyledComboBox.h"
 #include "ValueModeDelegate.h"
 
@@ -42,6 +44,7 @@
 #include <QIcon>
 #include <QInputDialog>
 #include <QIntValidator>
+#include <QJsonArray>
 #include <QLabel>
 #include <QLatin1String>
 #include <QLayout>
@@ -62,6 +65,7 @@
 #include <QTableWidgetItem>
 #include <QTextCharFormat>
 #include <QTextCursor>
+#include <QTimer>
 #include <QToolButton>
 #include <QVBoxLayout>
 
@@ -689,11 +693,12 @@ void DGLABClient::init_python_manager() {
     auto& config = AppConfig::instance();
     QString pythonPath = QString::fromStdString(config.get_value<std::string>("python.path", "python"));
     std::string bridge_module = config.get_value<std::string>("python.bridge_path", "./python/Bridge.py");
+    QString transport = QString::fromStdString(config.get_value<std::string>("python.transport", "auto"));
     LOG_MODULE("DGLABClient", "init_python_manager", LOG_INFO, "启动 Python 进程 -> [Python 解释器]路径: " << pythonPath.toStdString() << "（注: 若解释器路径直接为<Python>则使用系统默认 Python 路径）");
     LOG_MODULE("DGLABClient", "init_python_manager", LOG_INFO, "启动 Python 进程 -> [Python 服务模块]路径: " << bridge_module);
     if (bridge_module.starts_with(".")) bridge_module = bridge_module.substr(1);
     QString script_path = QCoreApplication::applicationDirPath() + QString::fromStdString(bridge_module);
-    py_manager_->start_process(pythonPath, script_path);
+    py_manager_->start_process(pythonPath, script_path, PythonSubprocessManager::transport_from_string(transport));
 }
 
 void DGLABClient::reset_py_log_level() {
@@ -716,6 +721,59 @@ void DGLABClient::reset_py_log_level() {
 void DGLABClient::setup_module_ui() {
     // 初始化数值模块管理器（幂等，注册默认 CS2 GSI 模块并启动调度器）
     ModuleManager::instance().init();
+    // 启动本地 CS2 GSI 接收端（CS2 以 HTTP POST 推送游戏状态，数值直接写入默认模块）
+    auto& config = AppConfig::instance();
+    if (config.get_value<bool>("app.gsi.enabled", true)) {
+        auto& gsi_listener = GsiListener::instance();
+        gsi_listener.set_auth_token(config.get_value<std::string>("app.gsi.token", ""));
+        gsi_listener.start(static_cast<quint16>(
+            config.get_value<int>("app.gsi.port", GsiListener::DEFAULT_PORT)));
+    }
+    // 共享内存数据源：本地生产者经 dglab_shm_ring.h 写入定长记录，消费线程直接发布到模块数值
+    if (config.get_value<bool>("app.shm.enabled", false)) {
+        ShmRingSource::instance().start(
+            config.get_value<std::string>("app.shm.name", ShmRingSource::DEFAULT_NAME),
+            static_cast<uint32_t>(config.get_value<int>("app.shm.capacity", ShmRingSource::DEFAULT_CAPACITY)));
+    }
+    // 退出前停止数据源（与 RuleManager::shutdown 一致）：消费线程与连接须在事件循环结束前停止，
+    // 不能留到静态析构（届时 QApplication 已销毁，发布数值的 invokeMethod 无处投递）
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, []() {
+        ShmRingSource::instance().stop();
+        GsiListener::instance().stop();
+    });
+    auto& module_manager = ModuleManager::instance();
+    // 自适应轮询：长时间不变的数值逐步降低轮询频率，变化或被启用的规则引用时恢复
+    if (config.get_value<bool>("app.adaptive_polling.enabled", false)) {
+        module_manager.set_adaptive_polling(true,
+            config.get_value<int>("app.adaptive_polling.idle_polls", ModuleManager::DEFAULT_ADAPTIVE_IDLE_POLLS),
+            config.get_value<int>("app.adaptive_polling.max_period_ms", ModuleManager::DEFAULT_ADAPTIVE_MAX_PERIOD_MS));
+    }
+    // 数值变化判定策略：app.change_policy.<数值 ID> = { deadband, deadband_ratio, hysteresis, min_interval_ms }
+    auto change_policies = config.get_value<nlohmann::json>("app.change_policy", nlohmann::json::object());
+    for (const auto& [value_id, entry] : change_policies.items()) {
+        std::string module_name = module_manager.find_module_by_value_id(value_id);
+        if (!entry.is_object() || module_name.empty()) {
+            LOG_MODULE("DGLABClient", "setup_module_ui", LOG_WARN, "忽略无效的变化判定策略: " << value_id);
+            continue;
+        }
+        ChangePolicy policy;
+        policy.deadband = entry.value("deadband", 0);
+        policy.deadband_ratio = entry.value("deadband_ratio", 0.0);
+        policy.hysteresis = entry.value("hysteresis", 0);
+        policy.min_interval_ms = entry.value("min_interval_ms", 0);
+        module_manager.set_value_change_policy(module_name, value_id, policy);
+    }
+    // 数值轨迹：录制全部数值更新，或回放录制的轨迹（无需运行游戏即可复现规则计算）
+    std::string trace_record_path = config.get_value<std::string>("app.trace.record_path", "");
+    if (!trace_record_path.empty()) {
+        ModuleManager::instance().start_trace_recording(QString::fromStdString(trace_record_path));
+    }
+    std::string trace_replay_path = config.get_value<std::string>("app.trace.replay_path", "");
+    if (!trace_replay_path.empty()) {
+        trace_replayer_ = new ValueTraceReplayer(this);
+        trace_replayer_->start(QString::fromStdString(trace_replay_path),
+            config.get_value<bool>("app.trace.replay_fast", false) ? 0.0 : 1.0);
+    }
 
     QVBoxLayout* page_layout = ui_.module_page_layout;
     page_layout->setContentsMargins(20, 20, 20, 20);
@@ -1148,6 +1206,7 @@ void DGLABClient::setup_rules_ui() {
 
 void DGLABClient::connect_rule_engine() {
     // 规则计算完成且父级为通道时，将命令发送给 Python 端
+    // 同一轮事件循环中就绪的命令（通常来自同一次级联）先暂存，轮末合并为一个 batch 命令发送
     connect(&RuleManager::instance(), &RuleManager::rule_command_ready,
         this, [this](const QJsonObject& cmd) {
             if (!is_connected_) {
@@ -1155,18 +1214,75 @@ void DGLABClient::connect_rule_engine() {
                     "未连接 Python 服务，规则命令未发送");
                 return;
             }
-            async_call(cmd, 5000, [this](bool ok, QString msg) {
+            pending_rule_commands_.append(cmd);
+            if (!rule_flush_scheduled_) {
+                rule_flush_scheduled_ = true;
+                QTimer::singleShot(0, this, &DGLABClient::flush_rule_commands);
+            }
+        });
+    LOG_MODULE("DGLABClient", "connect_rule_engine", LOG_INFO, "规则引擎信号连接完成");
+}
+
+void DGLABClient::flush_rule_commands() {
+    rule_flush_scheduled_ = false;
+    QJsonArray commands;
+    commands.swap(pending_rule_commands_);
+    if (commands.isEmpty()) {
+        return;
+    }
+    if (!is_connected_) {
+        LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_WARN,
+            "未连接 Python 服务，" << commands.size() << " 条规则命令未发送");
+        return;
+    }
+
+    // 单条命令保持原格式发送；多条按顺序分组为 batch，Python 端逐条执行并返回逐条状态
+    for (int begin = 0; begin < commands.size(); begin += RULE_BATCH_MAX_OPS) {
+        int count = std::min<int>(RULE_BATCH_MAX_OPS, commands.size() - begin);
+        if (count == 1) {
+            async_call(commands.at(begin).toObject(), RULE_COMMAND_TIMEOUT_MS, [](bool ok, QString msg) {
                 if (!ok) {
-                    LOG_MODULE("DGLABClient", "connect_rule_engine", LOG_ERROR,
+                    LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_ERROR,
                         "规则命令发送失败: " << msg.toStdString());
                 }
                 else {
-                    LOG_MODULE("DGLABClient", "connect_rule_engine", LOG_DEBUG,
+                    LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_DEBUG,
                         "规则命令已发送: " << msg.toStdString());
                 }
             });
-        });
-    LOG_MODULE("DGLABClient", "connect_rule_engine", LOG_INFO, "规则引擎信号连接完成");
+            continue;
+        }
+
+        QJsonArray ops;
+        for (int i = begin; i < begin + count; ++i) {
+            ops.append(commands.at(i));
+        }
+        QJsonObject batch{ {"cmd", "batch"}, {"ops", ops} };
+        LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_DEBUG, "合并 " << count << " 条规则命令为 batch 发送");
+        py_manager_->call(batch, [ops](const QJsonObject& resp) {
+            QString status = resp.value("status").toString();
+            if (status == "ok") {
+                LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_DEBUG,
+                    "规则命令已发送: " << resp.value("message").toString().toStdString());
+                return;
+            }
+            QJsonArray results = resp.value("results").toArray();
+            if (results.isEmpty()) {
+                // 整个 batch 失败（超时、连接断开或 Python 端不支持 batch）
+                LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_ERROR,
+                    "规则命令 batch 发送失败（" << ops.size() << " 条）: " << resp.value("message").toString().toStdString());
+                return;
+            }
+            for (int i = 0; i < results.size(); ++i) {
+                QJsonObject item = results.at(i).toObject();
+                if (item.value("status").toString() != "ok") {
+                    LOG_MODULE("DGLABClient", "flush_rule_commands", LOG_ERROR,
+                        "规则命令发送失败（batch 第 " << i << " 条，" << ops.at(i).toObject().value("cmd").toString().toStdString()
+                        << "）: " << item.value("message").toString().toStdString());
+                }
+            }
+        }, RULE_COMMAND_TIMEOUT_MS);
+    }
 }
 
 void DGLABClient::refresh_rule_file_list() {